@@ -0,0 +1,46 @@
+#include "BasicHeader.hpp"
+#include "AllocationsCounter.hpp"
+
+using namespace EngineCore;
+
+namespace
+{
+    atomic<bool> IsCounting = false;
+    atomic<ui32> Count = 0;
+}
+
+#ifdef COUNT_ALLOCATIONS
+
+void *operator new(std::size_t size)
+{
+    if (IsCounting.load(std::memory_order_relaxed))
+    {
+        Count.fetch_add(1, std::memory_order_relaxed);
+    }
+    void *memory = malloc(size ? size : 1);
+    if (memory == nullptr)
+    {
+        SOFTBREAK;
+        std::abort(); // exceptions are disabled, so bad_alloc can't be thrown
+    }
+    return memory;
+}
+
+void operator delete(void *memory) noexcept
+{
+    free(memory);
+}
+
+#endif
+
+void AllocationsCounter::Start()
+{
+    Count = 0;
+    IsCounting = true;
+}
+
+ui32 AllocationsCounter::Stop()
+{
+    IsCounting = false;
+    return Count.load();
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+// counts global operator new calls between Start and Stop, used by the headless benchmark and checks to verify allocation-free paths
+// the operator new replacement is compiled only with COUNT_ALLOCATIONS, which the Debug configuration defines, so shipping builds keep the default one
+namespace EngineCore::AllocationsCounter
+{
+#ifdef COUNT_ALLOCATIONS
+    inline constexpr bool IsAvailable = true;
+#else
+    inline constexpr bool IsAvailable = false;
+#endif
+
+    void Start(); // resets the count, counts allocations from every thread
+    ui32 Stop(); // returns the number of allocations since Start, always 0 if counting isn't available
+}
\ No newline at end of file
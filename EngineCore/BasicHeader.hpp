@@ -43,6 +43,8 @@ using std::experimental::nullopt;
 #include <variant>
 #include <mutex>
 #include <atomic>
+#include <thread>
+#include <span>
 #include <experimental\generator>
 #include <experimental\resumable>
 
@@ -74,6 +76,7 @@ using std::clamp;
 using std::variant;
 using std::mutex;
 using std::atomic;
+using std::span;
 using namespace std::literals::string_literals;
 
 #include <StdMiscLib.hpp>
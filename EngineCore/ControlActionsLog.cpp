@@ -0,0 +1,237 @@
+#include "BasicHeader.hpp"
+#include "ControlActionsLog.hpp"
+
+using namespace EngineCore;
+
+namespace
+{
+    uiw WriteVarint(ui64 value, ui8 *target)
+    {
+        uiw written = 0;
+        while (value >= 0x80)
+        {
+            target[written++] = (ui8)(value | 0x80);
+            value >>= 7;
+        }
+        target[written++] = (ui8)value;
+        return written;
+    }
+
+    bool ReadVarint(const ui8 *source, uiw sourceSize, uiw &offset, ui64 &value)
+    {
+        value = 0;
+        for (ui32 shift = 0; shift < 64; shift += 7)
+        {
+            if (offset == sourceSize)
+            {
+                return false;
+            }
+            ui8 byte = source[offset++];
+            value |= (ui64)(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uiw WriteI32(i32 value, ui8 *target)
+    {
+        ui32 zigzag = ((ui32)value << 1) ^ (ui32)(value >> 31);
+        return WriteVarint(zigzag, target);
+    }
+
+    bool ReadI32(const ui8 *source, uiw sourceSize, uiw &offset, i32 &value)
+    {
+        ui64 zigzag;
+        if (!ReadVarint(source, sourceSize, offset, zigzag) || zigzag > ui32_max)
+        {
+            return false;
+        }
+        value = (i32)((ui32)zigzag >> 1) ^ -(i32)(zigzag & 1);
+        return true;
+    }
+
+    uiw WriteVector(i32Vector2 value, ui8 *target)
+    {
+        uiw written = WriteI32(value.x, target);
+        return written + WriteI32(value.y, target + written);
+    }
+
+    bool ReadVector(const ui8 *source, uiw sourceSize, uiw &offset, i32Vector2 &value)
+    {
+        return ReadI32(source, sourceSize, offset, value.x) && ReadI32(source, sourceSize, offset, value.y);
+    }
+
+    uiw WriteF32(f32 value, ui8 *target)
+    {
+        MemOps::Copy(target, (ui8 *)&value, sizeof(f32));
+        return sizeof(f32);
+    }
+
+    bool ReadF32(const ui8 *source, uiw sourceSize, uiw &offset, f32 &value)
+    {
+        if (sourceSize - offset < sizeof(f32))
+        {
+            return false;
+        }
+        MemOps::Copy((ui8 *)&value, source + offset, sizeof(f32));
+        offset += sizeof(f32);
+        return true;
+    }
+
+    uiw WritePayload(const ControlAction &action, ui8 *target)
+    {
+        return std::visit([target](const auto &data) -> uiw
+        {
+            using type = std::decay_t<decltype(data)>;
+            if constexpr (std::is_same_v<type, ControlAction::Key>)
+            {
+                uiw written = WriteVarint((ui32)data.key, target);
+                target[written++] = (ui8)data.keyState;
+                return written;
+            }
+            else if constexpr (std::is_same_v<type, ControlAction::MouseSetPosition>)
+            {
+                return WriteVector(data.position, target);
+            }
+            else if constexpr (std::is_same_v<type, ControlAction::MouseMove> || std::is_same_v<type, ControlAction::TouchMove>)
+            {
+                return WriteVector(data.delta, target);
+            }
+            else if constexpr (std::is_same_v<type, ControlAction::MouseWheel>)
+            {
+                return WriteI32(data.delta, target);
+            }
+            else if constexpr (std::is_same_v<type, ControlAction::TouchDown> || std::is_same_v<type, ControlAction::TouchLongPress> || std::is_same_v<type, ControlAction::TouchDoubleTap>)
+            {
+                return WriteVector(data.position, target);
+            }
+            else if constexpr (std::is_same_v<type, ControlAction::TouchUp>)
+            {
+                return WriteVector(data.lastPosition, target);
+            }
+            else if constexpr (std::is_same_v<type, ControlAction::TouchZoomStart>)
+            {
+                return WriteVector(data.focusPoint, target);
+            }
+            else if constexpr (std::is_same_v<type, ControlAction::TouchZoom>)
+            {
+                uiw written = WriteVector(data.focusPoint, target);
+                return written + WriteF32(data.delta, target + written);
+            }
+            else
+            {
+                static_assert(std::is_same_v<type, ControlAction::TouchZoomEnd>, "unhandled ControlAction type");
+                return 0;
+            }
+        }, action.action);
+    }
+
+    template <typename T, typename Reader> bool ReadPayload(ControlAction &action, Reader &&reader)
+    {
+        T data;
+        if (!reader(data))
+        {
+            return false;
+        }
+        action.action = data;
+        return true;
+    }
+
+    // kind is the index of the action type in ControlAction::action
+    bool ReadPayload(const ui8 *source, uiw sourceSize, uiw &offset, uiw kind, ControlAction &action)
+    {
+        auto readPosition = [&](auto &data) { return ReadVector(source, sourceSize, offset, data.position); };
+        auto readDelta = [&](auto &data) { return ReadVector(source, sourceSize, offset, data.delta); };
+        auto readFocusPoint = [&](auto &data) { return ReadVector(source, sourceSize, offset, data.focusPoint); };
+
+        switch (kind)
+        {
+        case 0:
+            return ReadPayload<ControlAction::Key>(action, [&](ControlAction::Key &data)
+            {
+                ui64 key;
+                if (!ReadVarint(source, sourceSize, offset, key) || key >= (ui64)KeyCode::_size || offset == sourceSize || source[offset] > (ui8)ControlAction::Key::KeyState::Repeated)
+                {
+                    return false;
+                }
+                data.key = (KeyCode)key;
+                data.keyState = (ControlAction::Key::KeyState)source[offset++];
+                return true;
+            });
+        case 1:
+            return ReadPayload<ControlAction::MouseSetPosition>(action, readPosition);
+        case 2:
+            return ReadPayload<ControlAction::MouseMove>(action, readDelta);
+        case 3:
+            return ReadPayload<ControlAction::MouseWheel>(action, [&](ControlAction::MouseWheel &data) { return ReadI32(source, sourceSize, offset, data.delta); });
+        case 4:
+            return ReadPayload<ControlAction::TouchDown>(action, readPosition);
+        case 5:
+            return ReadPayload<ControlAction::TouchMove>(action, readDelta);
+        case 6:
+            return ReadPayload<ControlAction::TouchUp>(action, [&](ControlAction::TouchUp &data) { return ReadVector(source, sourceSize, offset, data.lastPosition); });
+        case 7:
+            return ReadPayload<ControlAction::TouchLongPress>(action, readPosition);
+        case 8:
+            return ReadPayload<ControlAction::TouchDoubleTap>(action, readPosition);
+        case 9:
+            return ReadPayload<ControlAction::TouchZoomStart>(action, readFocusPoint);
+        case 10:
+            return ReadPayload<ControlAction::TouchZoom>(action, [&](ControlAction::TouchZoom &data) { return readFocusPoint(data) && ReadF32(source, sourceSize, offset, data.delta); });
+        case 11:
+            return ReadPayload<ControlAction::TouchZoomEnd>(action, [](ControlAction::TouchZoomEnd &) { return true; });
+        }
+        return false;
+    }
+}
+
+uiw ControlActionsLog::Encode(const ControlAction &action, TimeMoment &previousMoment, ui8 *target)
+{
+    static_assert(std::variant_size_v<decltype(ControlAction::action)> <= 16, "action kind must fit into 4 bits");
+    ASSUME(action.device != DeviceTypes::_None);
+
+    ui64 deltaUs = 0;
+    if (action.occuredAt > previousMoment)
+    {
+        deltaUs = (ui64)((action.occuredAt - previousMoment).ToSec_f64() * 1'000'000.0 + 0.5);
+        // advanced by the rounded delta like Decode does, so the rounding errors don't accumulate over the recording
+        previousMoment = previousMoment + TimeDifference(deltaUs / 1'000'000.0);
+    }
+
+    uiw deviceBitIndex = Funcs::IndexOfMostSignificantNonZeroBit(action.device.AsInteger());
+
+    uiw written = WriteVarint(deltaUs, target);
+    written += WriteVarint(deviceBitIndex << 4 | action.action.index(), target + written);
+    written += WritePayload(action, target + written);
+    ASSUME(written <= MaxEncodedActionSize);
+    return written;
+}
+
+uiw ControlActionsLog::Decode(const ui8 *source, uiw sourceSize, TimeMoment &previousMoment, ControlAction &action)
+{
+    uiw offset = 0;
+    ui64 deltaUs, tag;
+    if (!ReadVarint(source, sourceSize, offset, deltaUs) || !ReadVarint(source, sourceSize, offset, tag))
+    {
+        return 0;
+    }
+
+    uiw deviceBitIndex = (uiw)(tag >> 4);
+    if (deviceBitIndex > Funcs::IndexOfMostSignificantNonZeroBit(DeviceTypes::_AllDevices.AsInteger()))
+    {
+        return 0;
+    }
+
+    if (!ReadPayload(source, sourceSize, offset, (uiw)(tag & 0xF), action))
+    {
+        return 0;
+    }
+
+    action.device = DeviceTypes::DeviceType::Create(1u << deviceBitIndex);
+    previousMoment = previousMoment + TimeDifference(deltaUs / 1'000'000.0);
+    action.occuredAt = previousMoment;
+    return offset;
+}
\ No newline at end of file
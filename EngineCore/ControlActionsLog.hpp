@@ -0,0 +1,31 @@
+#pragma once
+
+#include "IKeyController.hpp"
+
+// binary format for recorded control actions
+// the file starts with a Header, followed by the actions, each action is stored as
+// varint microseconds since the previous action (or since the recording has started for the first one),
+// varint (device bit index << 4 | action kind), and the action's payload,
+// integers are zigzag varints, floats are stored as is
+
+namespace EngineCore::ControlActionsLog
+{
+    struct Header
+    {
+        static constexpr ui32 SignatureValue = 'G' << 24 | 'L' << 16 | 'A' << 8 | 'C';
+        static constexpr ui32 CurrentVersion = 1;
+
+        ui32 signature = SignatureValue;
+        ui32 version = CurrentVersion;
+    };
+
+    static constexpr uiw MaxEncodedActionSize = 32;
+
+    // target must have at least MaxEncodedActionSize bytes available, returns the number of written bytes
+    // previousMoment is advanced by the stored delta, as Decode does, actions that go back in time are stored with zero delta
+    [[nodiscard]] uiw Encode(const ControlAction &action, TimeMoment &previousMoment, ui8 *target);
+
+    // returns the number of consumed bytes or 0 if the data is truncated or malformed
+    // previousMoment is advanced by the stored delta and becomes the action's moment
+    [[nodiscard]] uiw Decode(const ui8 *source, uiw sourceSize, TimeMoment &previousMoment, ControlAction &action);
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "BasicHeader.hpp"
+#include "FrameAllocator.hpp"
+
+using namespace EngineCore;
+
+namespace
+{
+    void NoOpDeleter(void *)
+    {}
+}
+
+FrameAllocator::FrameAllocator(uiw minChunkSize) : _minChunkSize(minChunkSize)
+{
+    ASSUME(minChunkSize > 0);
+}
+
+BufferOwnedData FrameAllocator::Allocate(uiw size, uiw alignment)
+{
+    ASSUME(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    auto alignedOffset = [alignment](const Chunk &chunk, uiw offset)
+    {
+        uiw address = (uiw)chunk.memory.get() + offset;
+        return offset + ((alignment - (address & (alignment - 1))) & (alignment - 1));
+    };
+
+    uiw offset = _chunks.empty() ? 0 : alignedOffset(_chunks.back(), _chunkOffset);
+    if (_chunks.empty() || offset + size > _chunks.back().size)
+    {
+        uiw chunkSize = std::max(_minChunkSize, size + alignment);
+        _chunks.push_back({make_unique<ui8[]>(chunkSize), chunkSize});
+        offset = alignedOffset(_chunks.back(), 0);
+    }
+
+    _chunkOffset = offset + size;
+    _usedBytes += size;
+    return BufferOwnedData(_chunks.back().memory.get() + offset, NoOpDeleter);
+}
+
+bool FrameAllocator::IsOwned(const void *memory) const
+{
+    for (const auto &chunk : _chunks)
+    {
+        if (memory >= chunk.memory.get() && memory < chunk.memory.get() + chunk.size)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FrameAllocator::Reset()
+{
+    if (_chunks.size() > 1)
+    {
+        uiw totalSize = CapacityBytes();
+        _chunks.clear();
+        _chunks.push_back({make_unique<ui8[]>(totalSize), totalSize});
+    }
+    _chunkOffset = 0;
+    _usedBytes = 0;
+}
+
+uiw FrameAllocator::UsedBytes() const
+{
+    return _usedBytes;
+}
+
+uiw FrameAllocator::CapacityBytes() const
+{
+    uiw bytes = 0;
+    for (const auto &chunk : _chunks)
+    {
+        bytes += chunk.size;
+    }
+    return bytes;
+}
\ No newline at end of file
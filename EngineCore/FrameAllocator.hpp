@@ -0,0 +1,37 @@
+#pragma once
+
+#include "RendererDataResource.hpp"
+
+namespace EngineCore
+{
+    // linear arena for data that lives until the end of the frame, e.g. the source of RendererArray::UpdateDataRegion
+    // the returned BufferOwnedData has a no-op deleter, so neither allocating nor freeing touches the heap once the arena has warmed up
+    // reset by Renderer::EndFrame, backends must copy transient data they want to keep, see Renderer::DetachTransientData
+    class FrameAllocator
+    {
+        struct Chunk
+        {
+            unique_ptr<ui8[]> memory;
+            uiw size;
+        };
+
+        vector<Chunk> _chunks{};
+        uiw _chunkOffset = 0; // in the last chunk
+        uiw _usedBytes = 0;
+        uiw _minChunkSize = 0;
+
+    public:
+        static constexpr uiw DefaultChunkSize = 256 * 1024;
+
+        FrameAllocator(uiw minChunkSize = DefaultChunkSize);
+
+        FrameAllocator(FrameAllocator &&) = delete;
+        FrameAllocator &operator = (FrameAllocator &&) = delete;
+
+        [[nodiscard]] BufferOwnedData Allocate(uiw size, uiw alignment = 16);
+        [[nodiscard]] bool IsOwned(const void *memory) const;
+        void Reset(); // if the frame needed several chunks, they're replaced with one that fits the whole frame
+        [[nodiscard]] uiw UsedBytes() const;
+        [[nodiscard]] uiw CapacityBytes() const;
+    };
+}
\ No newline at end of file
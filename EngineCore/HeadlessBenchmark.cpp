@@ -0,0 +1,401 @@
+#include "BasicHeader.hpp"
+#include "HeadlessBenchmarkModes.hpp"
+#include "Application.hpp"
+#include "Logger.hpp"
+#include "Camera.hpp"
+#include "RenderTarget.hpp"
+#include "NullRenderer.hpp"
+#include "KeyController.hpp"
+#include "ReplayKeyController.hpp"
+#include "AllocationsCounter.hpp"
+#include <..\TradingApp\PhysicsScene.hpp>
+
+using namespace EngineCore;
+
+namespace EngineCore::Application
+{
+    void SetEngineTime(EngineTime time);
+}
+
+namespace
+{
+    struct FrameTimings
+    {
+        f64 simulationMs;
+        f64 uploadMs;
+        f64 totalMs;
+        f64 sortMs;
+        ui32 stateChangesUnsorted;
+        ui32 stateChangesSorted;
+        ui32 drawAllocations;
+        f64 dispatchMs;
+        ui32 dispatchedActions;
+        TradingApp::PhysicsScene::DrawCounts sceneDraw;
+    };
+
+    bool WriteReport(const HeadlessBenchmark::Settings &settings, const vector<FrameTimings> &timings)
+    {
+        File file = File(settings.reportPath, FileOpenMode::CreateAlways, FileProcModes::Write);
+        if (!file.IsOpen())
+        {
+            SENDLOG(Error, "HeadlessBenchmark failed to create report file " PTHSTR "\n", settings.reportPath.PlatformPath().data());
+            return false;
+        }
+
+        char buffer[1024];
+        auto write = [&file, &buffer](i32 length)
+        {
+            return length > 0 && file.Write(buffer, (ui32)std::min(length, (i32)sizeof(buffer) - 1));
+        };
+
+        bool isWritten = true;
+        if (settings.reportFormat == HeadlessBenchmark::ReportFormat::CSV)
+        {
+            isWritten &= write(snprintf(buffer, sizeof(buffer), "frame,simulation_ms,upload_ms,total_ms,sort_ms,state_changes_unsorted,state_changes_sorted,draw_allocations,dispatch_ms,dispatched_actions,scene_draws,scene_state_changes_unsorted,scene_state_changes_sorted,scene_state_commands\n"));
+            for (uiw index = 0; index < timings.size(); ++index)
+            {
+                const auto &frame = timings[index];
+                isWritten &= write(snprintf(buffer, sizeof(buffer), "%u,%.4f,%.4f,%.4f,%.4f,%u,%u,%u,%.4f,%u,%u,%u,%u,%u\n", (ui32)index, frame.simulationMs, frame.uploadMs, frame.totalMs, frame.sortMs, frame.stateChangesUnsorted, frame.stateChangesSorted, frame.drawAllocations, frame.dispatchMs, frame.dispatchedActions,
+                    frame.sceneDraw.draws, frame.sceneDraw.stateChangesUnsorted, frame.sceneDraw.stateChangesSorted, frame.sceneDraw.stateCommands));
+            }
+        }
+        else
+        {
+            isWritten &= write(snprintf(buffer, sizeof(buffer), "{\n\t\"timestep\": %f,\n\t\"frames\": [\n", settings.timestep));
+            for (uiw index = 0; index < timings.size(); ++index)
+            {
+                const auto &frame = timings[index];
+                const char *separator = index + 1 < timings.size() ? "," : "";
+                isWritten &= write(snprintf(buffer, sizeof(buffer), "\t\t{\"frame\": %u, \"simulation_ms\": %.4f, \"upload_ms\": %.4f, \"total_ms\": %.4f, \"sort_ms\": %.4f, \"state_changes_unsorted\": %u, \"state_changes_sorted\": %u, \"draw_allocations\": %u, \"dispatch_ms\": %.4f, \"dispatched_actions\": %u, \"scene_draws\": %u, \"scene_state_changes_unsorted\": %u, \"scene_state_changes_sorted\": %u, \"scene_state_commands\": %u}%s\n",
+                    (ui32)index, frame.simulationMs, frame.uploadMs, frame.totalMs, frame.sortMs, frame.stateChangesUnsorted, frame.stateChangesSorted, frame.drawAllocations, frame.dispatchMs, frame.dispatchedActions,
+                    frame.sceneDraw.draws, frame.sceneDraw.stateChangesUnsorted, frame.sceneDraw.stateChangesSorted, frame.sceneDraw.stateCommands, separator));
+            }
+            isWritten &= write(snprintf(buffer, sizeof(buffer), "\t]\n}\n"));
+        }
+
+        if (!isWritten)
+        {
+            SENDLOG(Error, "HeadlessBenchmark failed to write report file " PTHSTR "\n", settings.reportPath.PlatformPath().data());
+        }
+        return isWritten;
+    }
+}
+
+bool HeadlessBenchmark::WriteMetricsReport(const Settings &settings, span<const Metric> metrics)
+{
+    File file = File(settings.reportPath, FileOpenMode::CreateAlways, FileProcModes::Write);
+    if (!file.IsOpen())
+    {
+        SENDLOG(Error, "HeadlessBenchmark failed to create report file " PTHSTR "\n", settings.reportPath.PlatformPath().data());
+        return false;
+    }
+
+    char buffer[256];
+    auto write = [&file, &buffer](i32 length)
+    {
+        return length > 0 && file.Write(buffer, (ui32)std::min(length, (i32)sizeof(buffer) - 1));
+    };
+
+    bool isWritten = true;
+    bool isCSV = settings.reportFormat == HeadlessBenchmark::ReportFormat::CSV;
+    if (isCSV)
+    {
+        for (uiw index = 0; index < metrics.size(); ++index)
+        {
+            isWritten &= write(snprintf(buffer, sizeof(buffer), "%s%s", metrics[index].name, index + 1 < metrics.size() ? "," : "\n"));
+        }
+        for (uiw index = 0; index < metrics.size(); ++index)
+        {
+            isWritten &= write(snprintf(buffer, sizeof(buffer), "%.4f%s", metrics[index].value, index + 1 < metrics.size() ? "," : "\n"));
+        }
+    }
+    else
+    {
+        isWritten &= write(snprintf(buffer, sizeof(buffer), "{\n"));
+        for (uiw index = 0; index < metrics.size(); ++index)
+        {
+            isWritten &= write(snprintf(buffer, sizeof(buffer), "\t\"%s\": %.4f%s\n", metrics[index].name, metrics[index].value, index + 1 < metrics.size() ? "," : ""));
+        }
+        isWritten &= write(snprintf(buffer, sizeof(buffer), "}\n"));
+    }
+
+    if (!isWritten)
+    {
+        SENDLOG(Error, "HeadlessBenchmark failed to write report file " PTHSTR "\n", settings.reportPath.PlatformPath().data());
+    }
+    return isWritten;
+}
+
+auto HeadlessBenchmark::ParseCommandLine(i32 argc, const char *const *argv) -> optional<Settings>
+{
+    if (argc < 2 || string_view(argv[1]) != "-headless_benchmark")
+    {
+        return nullopt;
+    }
+
+    Settings settings;
+    for (i32 index = 2; index < argc; ++index)
+    {
+        string_view arg = argv[index];
+        auto value = [arg](string_view key) -> optional<string_view>
+        {
+            if (arg.size() > key.size() && arg.substr(0, key.size()) == key && arg[key.size()] == '=')
+            {
+                return arg.substr(key.size() + 1);
+            }
+            return nullopt;
+        };
+
+        if (auto mode = value("mode"))
+        {
+            if (*mode == "scene")
+            {
+                settings.mode = Mode::Scene;
+            }
+            else if (*mode == "spsc_stress")
+            {
+                settings.mode = Mode::SPSCStress;
+            }
+            else if (*mode == "ring_iteration")
+            {
+                settings.mode = Mode::RingIteration;
+            }
+            else if (*mode == "system_uniforms")
+            {
+                settings.mode = Mode::SystemUniforms;
+            }
+            else
+            {
+                SENDLOG(Error, "HeadlessBenchmark got unknown mode %*s\n", SVIEWARG(*mode));
+                return nullopt;
+            }
+        }
+        else if (auto items = value("items"))
+        {
+            settings.itemsCount = (ui32)strtoul(items->data(), nullptr, 10);
+        }
+        else if (auto frames = value("frames"))
+        {
+            settings.framesCount = (ui32)strtoul(frames->data(), nullptr, 10);
+        }
+        else if (auto timestep = value("timestep"))
+        {
+            settings.timestep = strtof(timestep->data(), nullptr);
+        }
+        else if (auto controls = value("controls"))
+        {
+            settings.controlsLog = FilePath::FromChar(controls->data());
+        }
+        else if (auto syntheticControls = value("synthetic_controls"))
+        {
+            settings.syntheticControlsRate = (ui32)strtoul(syntheticControls->data(), nullptr, 10);
+        }
+        else if (auto sortDraws = value("sort_draws"))
+        {
+            settings.sortedDrawsCount = (ui32)strtoul(sortDraws->data(), nullptr, 10);
+        }
+        else if (auto report = value("report"))
+        {
+            settings.reportPath = FilePath::FromChar(report->data());
+            bool isJson = report->size() >= 5 && report->substr(report->size() - 5) == ".json";
+            settings.reportFormat = isJson ? ReportFormat::JSON : ReportFormat::CSV;
+        }
+        else
+        {
+            SENDLOG(Warning, "HeadlessBenchmark ignores unknown argument %*s\n", SVIEWARG(arg));
+        }
+    }
+
+    if (settings.framesCount == 0 || settings.timestep <= 0.0f)
+    {
+        SENDLOG(Error, "HeadlessBenchmark requires a positive frames count and timestep\n");
+        return nullopt;
+    }
+    if (settings.itemsCount == 0)
+    {
+        SENDLOG(Error, "HeadlessBenchmark requires a positive items count\n");
+        return nullopt;
+    }
+
+    return settings;
+}
+
+bool HeadlessBenchmark::Run(const Settings &settings)
+{
+    if (settings.mode == Mode::SPSCStress)
+    {
+        return RunSPSCStress(settings);
+    }
+    if (settings.mode == Mode::RingIteration)
+    {
+        return RunRingIteration(settings);
+    }
+    if (settings.mode == Mode::SystemUniforms)
+    {
+        return RunSystemUniforms(settings);
+    }
+
+    optional<FilePath> controlsLog = settings.controlsLog;
+    if (settings.syntheticControlsRate)
+    {
+        controlsLog = controlsLog.value_or(FilePath::FromChar("synthetic_controls.log"));
+        if (!GenerateSyntheticControls(*controlsLog, settings.syntheticControlsRate, (f64)settings.framesCount * settings.timestep))
+        {
+            return false;
+        }
+    }
+
+    auto keyController = shared_ptr<IKeyController>(KeyController::New());
+    shared_ptr<QueueingKeyController> queueingController;
+    shared_ptr<ReplayKeyController> replayController;
+    if (controlsLog)
+    {
+        queueingController = make_shared<QueueingKeyController>(keyController);
+        replayController = ReplayKeyController::New(queueingController, *controlsLog);
+        if (replayController == nullptr)
+        {
+            return false;
+        }
+        keyController = replayController;
+    }
+    Application::SetKeyController(keyController);
+
+    // the camera still needs the window size for its projection
+    AppWindow appWindow;
+    appWindow.title = "HeadlessBenchmark";
+    appWindow.width = 1920;
+    appWindow.height = 1080;
+    Application::SetMainWindow(appWindow);
+
+    Application::SetRenderer(NullRenderer::New());
+
+    EngineTime engineTime;
+    Application::SetEngineTime(engineTime);
+
+    const auto &camera = Application::GetMainCamera();
+    camera->RenderTarget(RenderTarget::New());
+    camera->Position(Vector3(5, 50, -75));
+
+    if (TradingApp::PhysicsScene::Create(true) == false)
+    {
+        SENDLOG(Critical, "HeadlessBenchmark failed to create the scene\n");
+        TradingApp::PhysicsScene::Destroy();
+        Application::SetRenderer(nullptr);
+        return false;
+    }
+
+    vector<FrameTimings> timings;
+    timings.reserve(settings.framesCount);
+    vector<RendererDrawQueue::SortEntry> sortEntries, sortScratch;
+
+    ui32 sceneRestartedCounter = 0;
+    TimeDifference timestep = TimeDifference((f64)settings.timestep);
+
+    for (ui32 frame = 0; frame < settings.framesCount; ++frame)
+    {
+        auto frameStart = TimeMoment::Now();
+
+        engineTime.secondsSinceStart += settings.timestep * engineTime.timeScale;
+        engineTime.secondSinceLastFrame = settings.timestep * engineTime.timeScale;
+        engineTime.unscaledSecondSinceLastFrame = settings.timestep;
+        Application::SetEngineTime(engineTime);
+
+        f64 dispatchMs = 0;
+        ui32 dispatchedActions = 0;
+        if (replayController)
+        {
+            replayController->Advance(timestep);
+            auto dispatchStart = TimeMoment::Now();
+            dispatchedActions = queueingController->DispatchQueued();
+            dispatchMs = (TimeMoment::Now() - dispatchStart).ToSec_f64() * 1000.0;
+        }
+
+        Application::GetRenderer().BeginFrame();
+
+        if (ui32 newCounter = Application::GetKeyController().GetKeyInfo(KeyCode::Space).timesKeyStateChanged; newCounter != sceneRestartedCounter)
+        {
+            sceneRestartedCounter = newCounter;
+            TradingApp::PhysicsScene::Restart();
+        }
+
+        auto simulationStart = TimeMoment::Now();
+        TradingApp::PhysicsScene::Update(camera->Position(), camera->Rotation());
+        auto uploadStart = TimeMoment::Now();
+        AllocationsCounter::Start();
+        auto sceneDraw = TradingApp::PhysicsScene::Draw(*camera);
+        ui32 drawAllocations = AllocationsCounter::Stop();
+        auto uploadEnd = TimeMoment::Now();
+
+        SortResult sortResult{};
+        if (settings.sortedDrawsCount)
+        {
+            sortResult = SortSyntheticDraws(settings.sortedDrawsCount, frame, sortEntries, sortScratch);
+        }
+
+        Application::GetRenderer().EndFrame();
+
+        auto frameEnd = TimeMoment::Now();
+
+        timings.push_back({(uploadStart - simulationStart).ToSec_f64() * 1000.0, (uploadEnd - uploadStart).ToSec_f64() * 1000.0, (frameEnd - frameStart).ToSec_f64() * 1000.0, sortResult.sortMs, sortResult.stateChangesUnsorted, sortResult.stateChangesSorted, drawAllocations, dispatchMs, dispatchedActions, sceneDraw});
+    }
+
+    Application::GetRenderer().ReportArraysMemory();
+
+    TradingApp::PhysicsScene::Destroy();
+    Application::SetRenderer(nullptr);
+
+    f64 totalMs = 0, maxFrameMs = 0;
+    ui32 maxDrawAllocations = 0;
+    for (const auto &frame : timings)
+    {
+        totalMs += frame.totalMs;
+        maxFrameMs = std::max(maxFrameMs, frame.totalMs);
+        maxDrawAllocations = std::max(maxDrawAllocations, frame.drawAllocations);
+    }
+    SENDLOG(Info, "HeadlessBenchmark finished %u frames, average frame %.3fms, max frame %.3fms\n", settings.framesCount, totalMs / settings.framesCount, maxFrameMs);
+    if constexpr (AllocationsCounter::IsAvailable)
+    {
+        SENDLOG(Info, "HeadlessBenchmark drawing allocated at most %u times per frame, the first frame allocated %u times\n", maxDrawAllocations, timings.empty() ? 0 : timings[0].drawAllocations);
+    }
+    else
+    {
+        SENDLOG(Info, "HeadlessBenchmark doesn't count allocations, the build doesn't define COUNT_ALLOCATIONS\n");
+    }
+
+    ui64 sceneDraws = 0, sceneUnsorted = 0, sceneSorted = 0, sceneStateCommands = 0;
+    for (const auto &frame : timings)
+    {
+        sceneDraws += frame.sceneDraw.draws;
+        sceneUnsorted += frame.sceneDraw.stateChangesUnsorted;
+        sceneSorted += frame.sceneDraw.stateChangesSorted;
+        sceneStateCommands += frame.sceneDraw.stateCommands;
+    }
+    SENDLOG(Info, "HeadlessBenchmark scene submitted %u draws per frame through the draw queue, state changes %u -> %u per frame, %u state commands per frame\n", (ui32)(sceneDraws / settings.framesCount), (ui32)(sceneUnsorted / settings.framesCount), (ui32)(sceneSorted / settings.framesCount), (ui32)(sceneStateCommands / settings.framesCount));
+
+    if (queueingController)
+    {
+        f64 dispatchMs = 0, maxDispatchMs = 0;
+        for (const auto &frame : timings)
+        {
+            dispatchMs += frame.dispatchMs;
+            maxDispatchMs = std::max(maxDispatchMs, frame.dispatchMs);
+        }
+        const ControlsQueue &queue = queueingController->Queue();
+        SENDLOG(Info, "HeadlessBenchmark replayed %u actions, %u coalesced, %u dropped, dispatch took %.4fms on average, %.4fms at most, the queue's high watermark is %u of %u\n", (ui32)queueingController->ReceivedCount(), (ui32)queue.CoalescedCount(), (ui32)queue.DroppedCount(), dispatchMs / settings.framesCount, maxDispatchMs, (ui32)queue.HighWatermark(), (ui32)ControlsQueue::Capacity());
+    }
+
+    if (settings.sortedDrawsCount)
+    {
+        f64 sortMs = 0;
+        ui64 unsorted = 0, sorted = 0;
+        for (const auto &frame : timings)
+        {
+            sortMs += frame.sortMs;
+            unsorted += frame.stateChangesUnsorted;
+            sorted += frame.stateChangesSorted;
+        }
+        SENDLOG(Info, "HeadlessBenchmark sorted %u draws per frame in %.3fms on average, state changes %u -> %u per frame\n", settings.sortedDrawsCount, sortMs / settings.framesCount, (ui32)(unsorted / settings.framesCount), (ui32)(sorted / settings.framesCount));
+    }
+
+    return WriteReport(settings, timings);
+}
\ No newline at end of file
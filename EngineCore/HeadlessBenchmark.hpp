@@ -0,0 +1,44 @@
+#pragma once
+
+namespace EngineCore::HeadlessBenchmark
+{
+    enum class ReportFormat { CSV, JSON };
+
+    enum class Mode
+    {
+        Scene, // PhysicsScene frames
+        SPSCStress, // SPSCRingBuffer throughput and latency between a producer and a consumer thread
+        RingIteration, // RingBuffer traversal with the iterator and with spans()
+        SystemUniforms // DrawGeneric's system uniform setup against stubbed uniform functions
+    };
+
+    struct Settings
+    {
+        ui32 framesCount = 1000;
+        f32 timestep = 1.0f / 60.0f;
+        optional<FilePath> controlsLog{}; // recorded by RecordingKeyController, no input is injected if it's not set
+        ui32 syntheticControlsRate = 0; // mouse actions per second, if set, a log of that rate spanning all the frames is generated into controlsLog (or synthetic_controls.log) first
+        FilePath reportPath = FilePath::FromChar("benchmark.csv");
+        ReportFormat reportFormat = ReportFormat::CSV;
+        ui32 sortedDrawsCount = 0; // synthetic draw keys radix sorted every frame, e.g. 100000, 0 disables
+        Mode mode = Mode::Scene;
+        ui32 itemsCount = 1 << 22; // passed through the buffer by SPSCStress, visited by every RingIteration traversal, draws set up by SystemUniforms
+    };
+
+    // expects -headless_benchmark [mode=scene|spsc_stress|ring_iteration|system_uniforms] [frames=N] [timestep=S] [controls=PATH] [report=PATH] [sort_draws=N] [items=N] [synthetic_controls=HZ]
+    // the report format is JSON if PATH ends with .json
+    optional<Settings> ParseCommandLine(i32 argc, const char *const *argv);
+
+    // runs PhysicsScene for a fixed number of frames with a fixed timestep, without a window and a GPU
+    // and writes per-frame simulation, upload and total time into the report, along with the number of heap allocations made while drawing in builds with COUNT_ALLOCATIONS
+    // and the scene's draw queue counts: draws, estimated state changes before and after sorting and the state commands submitted
+    // with sort_draws it also sorts that many draw keys every frame and reports the sort time and the state changes before and after sorting
+    // the replayed controls go through a coalescing ControlsQueue like the windowed app's input does, the number of coalesced actions and the dispatch time are reported
+    // Application must be created, but the renderer and the scene must not be
+    // spsc_stress instead pushes items stamped with the push time from a producer thread to a consumer thread, each pinned to its own core when there're at least two,
+    // and reports the throughput and the push to pop latency percentiles
+    // ring_iteration sums wrapped-around RingBuffers of a power of two and of an arbitrary size with the iterator and with spans() and reports the time per element
+    // system_uniforms runs the renderer's per-draw system uniform setup through the slot table and, for comparison, the search by name it replaced,
+    // with glUniform* replaced by stubs, for Colored3DVertices and for a shader with every system uniform, and reports the time per draw
+    bool Run(const Settings &settings);
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "BasicHeader.hpp"
+#include "HeadlessBenchmarkModes.hpp"
+#include "Logger.hpp"
+#include "ControlActionsLog.hpp"
+
+using namespace EngineCore;
+
+bool HeadlessBenchmark::GenerateSyntheticControls(const FilePath &path, ui32 rate, f64 durationSeconds)
+{
+    File file = File(path, FileOpenMode::CreateAlways, FileProcModes::Write);
+    ControlActionsLog::Header header;
+    if (!file.IsOpen() || !file.Write(&header, sizeof(header)))
+    {
+        SENDLOG(Error, "HeadlessBenchmark failed to create synthetic controls log " PTHSTR "\n", path.PlatformPath().data());
+        return false;
+    }
+
+    array<ui8, 4096> buffer;
+    uiw bufferSize = 0;
+    bool isWritten = true;
+    auto write = [&](const ControlAction &action, TimeMoment &previousMoment)
+    {
+        if (bufferSize + ControlActionsLog::MaxEncodedActionSize > buffer.size())
+        {
+            isWritten &= file.Write(buffer.data(), (ui32)bufferSize);
+            bufferSize = 0;
+        }
+        bufferSize += ControlActionsLog::Encode(action, previousMoment, buffer.data() + bufferSize);
+    };
+
+    TimeMoment start = TimeMoment::Now();
+    TimeMoment previousMoment = start;
+    ui64 movesCount = (ui64)(durationSeconds * rate);
+    ui64 movesPerButtonChange = std::max<ui64>(rate / 4, 1);
+    bool isButtonPressed = false;
+    for (ui64 move = 0; move < movesCount; ++move)
+    {
+        TimeMoment moment = start + TimeDifference((f64)move / rate);
+        i32 step = (i32)(move % 5) - 2;
+        write(ControlAction{ControlAction::MouseMove{i32Vector2(step, 1 - step)}, moment, DeviceTypes::MouseKeyboard}, previousMoment);
+        if (move % 16 == 15)
+        {
+            write(ControlAction{ControlAction::MouseWheel{move % 32 < 16 ? 1 : -1}, moment, DeviceTypes::MouseKeyboard}, previousMoment);
+        }
+        if (move % movesPerButtonChange == movesPerButtonChange - 1)
+        {
+            isButtonPressed = !isButtonPressed;
+            auto keyState = isButtonPressed ? ControlAction::Key::KeyState::Pressed : ControlAction::Key::KeyState::Released;
+            write(ControlAction{ControlAction::Key{KeyCode::MButton0, keyState}, moment, DeviceTypes::MouseKeyboard}, previousMoment);
+        }
+    }
+    if (bufferSize)
+    {
+        isWritten &= file.Write(buffer.data(), (ui32)bufferSize);
+    }
+
+    if (!isWritten)
+    {
+        SENDLOG(Error, "HeadlessBenchmark failed to write synthetic controls log " PTHSTR "\n", path.PlatformPath().data());
+        return false;
+    }
+    SENDLOG(Info, "HeadlessBenchmark generated %u mouse moves at %uHz into " PTHSTR "\n", (ui32)movesCount, rate, path.PlatformPath().data());
+    return true;
+}
\ No newline at end of file
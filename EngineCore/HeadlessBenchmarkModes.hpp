@@ -0,0 +1,124 @@
+#pragma once
+
+#include "HeadlessBenchmark.hpp"
+#include "IKeyController.hpp"
+#include "RendererDrawQueue.hpp"
+
+// the parts of HeadlessBenchmark shared between its files, the command line, the scene mode and the reports are in HeadlessBenchmark.cpp,
+// every other mode and every optional workload of the scene mode has its own file
+namespace EngineCore::HeadlessBenchmark
+{
+    struct Metric
+    {
+        const char *name;
+        f64 value;
+    };
+
+    // for modes that produce a single set of results instead of per-frame timings
+    bool WriteMetricsReport(const Settings &settings, span<const Metric> metrics);
+
+    // spsc_stress, HeadlessBenchmarkSPSCStress.cpp
+    bool RunSPSCStress(const Settings &settings);
+
+    // ring_iteration, HeadlessBenchmarkRingIteration.cpp
+    bool RunRingIteration(const Settings &settings);
+
+    // system_uniforms, HeadlessBenchmarkSystemUniforms.cpp
+    bool RunSystemUniforms(const Settings &settings);
+
+    // synthetic_controls and the replayed controls, HeadlessBenchmarkControls.cpp
+    // mouse moves at the given rate with a wheel step after every 16 moves and a button press or release every 250ms,
+    // which is what a high polling rate mouse produces while the user drags and scrolls
+    bool GenerateSyntheticControls(const FilePath &path, ui32 rate, f64 durationSeconds);
+
+    // collects the replayed actions into a ControlsQueue and dispatches them once per frame, like the window procedure and the message loop do
+    class QueueingKeyController : public IKeyController
+    {
+        shared_ptr<IKeyController> _nextController{};
+        ControlsQueue _queue{};
+        uiw _receivedCount = 0;
+
+    public:
+        QueueingKeyController(const shared_ptr<IKeyController> &nextController) : _nextController(nextController)
+        {
+            _queue.CoalesceMoves(true);
+        }
+
+        virtual void Dispatch(const ControlAction &action) override
+        {
+            ++_receivedCount;
+            [[maybe_unused]] bool isQueued = _queue.Enqueue(action); // dropped ones are counted by the queue
+        }
+
+        virtual void Dispatch(span<const ControlAction> actions) override
+        {
+            for (const auto &action : actions)
+            {
+                Dispatch(action);
+            }
+        }
+
+        virtual void Update() override
+        {
+            _nextController->Update();
+        }
+
+        [[nodiscard]] virtual KeyInfo GetKeyInfo(KeyCode key, DeviceTypes::DeviceType device) const override
+        {
+            return _nextController->GetKeyInfo(key, device);
+        }
+
+        [[nodiscard]] virtual optional<i32Vector2> GetPositionInfo(DeviceTypes::DeviceType device) const override
+        {
+            return _nextController->GetPositionInfo(device);
+        }
+
+        [[nodiscard]] virtual const AllKeyStates &GetAllKeyStates(DeviceTypes::DeviceType device) const override
+        {
+            return _nextController->GetAllKeyStates(device);
+        }
+
+        [[nodiscard]] virtual ListenerHandle OnControlAction(const ListenerCallbackType &callback, DeviceTypes::DeviceType deviceMask, ControlActionKinds::ControlActionKind kindMask) override
+        {
+            return _nextController->OnControlAction(callback, deviceMask, kindMask);
+        }
+
+        virtual void RemoveListener(ListenerHandle &handle) override
+        {
+            _nextController->RemoveListener(handle);
+        }
+
+        // returns the number of dispatched actions
+        ui32 DispatchQueued()
+        {
+            ui32 dispatchedCount = (ui32)_queue.size();
+            for (auto actions : _queue.Spans())
+            {
+                _nextController->Dispatch(actions);
+            }
+            _queue.clear();
+            return dispatchedCount;
+        }
+
+        [[nodiscard]] const ControlsQueue &Queue() const
+        {
+            return _queue;
+        }
+
+        [[nodiscard]] uiw ReceivedCount() const
+        {
+            return _receivedCount;
+        }
+    };
+
+    // sort_draws, HeadlessBenchmarkSortDraws.cpp
+    struct SortResult
+    {
+        f64 sortMs;
+        ui32 stateChangesUnsorted;
+        ui32 stateChangesSorted;
+    };
+
+    // keys shaped like a scene's, materials are the most numerous and each one belongs to a single shader and pipeline state
+    SortResult SortSyntheticDraws(ui32 drawsCount, ui32 frame, vector<RendererDrawQueue::SortEntry> &entries, vector<RendererDrawQueue::SortEntry> &scratch);
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "BasicHeader.hpp"
+#include "HeadlessBenchmarkModes.hpp"
+#include "Logger.hpp"
+#include "RingBuffer.h"
+
+using namespace EngineCore;
+
+namespace
+{
+    struct IterationResult
+    {
+        f64 iteratorNs; // per element
+        f64 spansNs;
+        bool isSumMatching;
+    };
+
+    // the buffer is filled past its capacity, so the elements wrap around the end of the storage and spans() returns two parts
+    template <uiw MaxElements> IterationResult MeasureRingIteration(ui32 itemsCount)
+    {
+        auto buffer = make_unique<RingBuffer<ui32, MaxElements>>();
+        for (ui32 value = 0; value < MaxElements + MaxElements / 3; ++value)
+        {
+            buffer->push_back(value);
+        }
+        ui32 passesCount = std::max(1u, itemsCount / (ui32)MaxElements);
+        f64 elementsCount = (f64)passesCount * MaxElements;
+
+        ui64 iteratorSum = 0;
+        auto iteratorStart = TimeMoment::Now();
+        for (ui32 pass = 0; pass < passesCount; ++pass)
+        {
+            for (ui32 value : *buffer)
+            {
+                iteratorSum += value;
+            }
+        }
+        auto iteratorEnd = TimeMoment::Now();
+
+        ui64 spansSum = 0;
+        for (ui32 pass = 0; pass < passesCount; ++pass)
+        {
+            for (auto part : buffer->spans())
+            {
+                for (ui32 value : part)
+                {
+                    spansSum += value;
+                }
+            }
+        }
+        auto spansEnd = TimeMoment::Now();
+
+        return {(iteratorEnd - iteratorStart).ToSec_f64() * 1e9 / elementsCount, (spansEnd - iteratorEnd).ToSec_f64() * 1e9 / elementsCount, iteratorSum == spansSum};
+    }
+}
+
+bool HeadlessBenchmark::RunRingIteration(const Settings &settings)
+{
+    // 4096 uses mask arithmetic, 4000 compares against the end of the storage on every step
+    IterationResult powerOfTwo = MeasureRingIteration<4096>(settings.itemsCount);
+    IterationResult arbitrary = MeasureRingIteration<4000>(settings.itemsCount);
+
+    SENDLOG(Info, "HeadlessBenchmark ring_iteration of 4096 elements: iterator %.3fns, spans %.3fns per element\n", powerOfTwo.iteratorNs, powerOfTwo.spansNs);
+    SENDLOG(Info, "HeadlessBenchmark ring_iteration of 4000 elements: iterator %.3fns, spans %.3fns per element\n", arbitrary.iteratorNs, arbitrary.spansNs);
+    if (!powerOfTwo.isSumMatching || !arbitrary.isSumMatching)
+    {
+        SENDLOG(Error, "HeadlessBenchmark ring_iteration got different sums from the iterator and spans\n");
+    }
+
+    const Metric metrics[] =
+    {
+        {"items", (f64)settings.itemsCount},
+        {"pow2_iterator_ns", powerOfTwo.iteratorNs},
+        {"pow2_spans_ns", powerOfTwo.spansNs},
+        {"arbitrary_iterator_ns", arbitrary.iteratorNs},
+        {"arbitrary_spans_ns", arbitrary.spansNs},
+    };
+    return WriteMetricsReport(settings, metrics) && powerOfTwo.isSumMatching && arbitrary.isSumMatching;
+}
\ No newline at end of file
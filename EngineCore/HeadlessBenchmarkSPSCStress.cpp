@@ -0,0 +1,114 @@
+#include "BasicHeader.hpp"
+#include "HeadlessBenchmarkModes.hpp"
+#include "Logger.hpp"
+#include "RingBuffer.h"
+
+using namespace EngineCore;
+
+namespace
+{
+    // the value below which the given fraction of the samples lie, reorders the samples
+    f64 Percentile(vector<f64> &samples, f64 fraction)
+    {
+        ASSUME(samples.size());
+        auto nth = samples.begin() + std::min((uiw)(fraction * samples.size()), samples.size() - 1);
+        std::nth_element(samples.begin(), nth, samples.end());
+        return *nth;
+    }
+
+    // the logger isn't thread safe, so the caller reports failures
+    bool PinCurrentThreadToCore(ui32 core)
+    {
+#ifdef WINPLATFORM
+        return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << core) != 0;
+#else
+        return false;
+#endif
+    }
+}
+
+bool HeadlessBenchmark::RunSPSCStress(const Settings &settings)
+{
+    // the sequence lets the consumer verify that nothing has been lost or reordered
+    struct Item
+    {
+        TimeMoment pushedAt;
+        ui32 sequence;
+    };
+    constexpr uiw pushBatch = 16, popBatch = 64;
+
+    // the same capacity as ControlsQueue, Block makes the producer wait instead of dropping, so every item is delivered
+    auto buffer = make_unique<SPSCRingBuffer<Item, 256, RingBufferOverflowPolicy::Block>>();
+    vector<f64> latenciesUs(settings.itemsCount);
+    bool isPinningRequired = std::thread::hardware_concurrency() >= 2;
+    bool isProducerPinned = false, isConsumerPinned = false;
+    ui32 outOfOrderCount = 0;
+
+    auto start = TimeMoment::Now();
+
+    std::thread consumer([&]
+    {
+        isConsumerPinned = isPinningRequired && PinCurrentThreadToCore(1);
+        Item items[popBatch];
+        for (ui32 expected = 0; expected < settings.itemsCount; )
+        {
+            uiw popped = buffer->pop_range(items, popBatch);
+            if (popped == 0)
+            {
+                std::this_thread::yield(); // matters only when both threads share a core
+                continue;
+            }
+            auto poppedAt = TimeMoment::Now();
+            for (uiw index = 0; index < popped; ++index, ++expected)
+            {
+                outOfOrderCount += items[index].sequence != expected;
+                latenciesUs[expected] = (poppedAt - items[index].pushedAt).ToSec_f64() * 1'000'000.0;
+            }
+        }
+    });
+
+    std::thread producer([&]
+    {
+        isProducerPinned = isPinningRequired && PinCurrentThreadToCore(0);
+        Item items[pushBatch];
+        for (ui32 sequence = 0; sequence < settings.itemsCount; )
+        {
+            uiw count = std::min<uiw>(pushBatch, settings.itemsCount - sequence);
+            auto pushedAt = TimeMoment::Now();
+            for (uiw index = 0; index < count; ++index)
+            {
+                items[index] = {pushedAt, sequence + (ui32)index};
+            }
+            sequence += (ui32)buffer->push_range(items, count);
+        }
+    });
+
+    producer.join();
+    consumer.join();
+    bool isPinned = isProducerPinned && isConsumerPinned;
+
+    f64 seconds = (TimeMoment::Now() - start).ToSec_f64();
+    f64 itemsPerSecond = settings.itemsCount / seconds;
+    f64 p50 = Percentile(latenciesUs, 0.5), p99 = Percentile(latenciesUs, 0.99), p999 = Percentile(latenciesUs, 0.999);
+    f64 maxLatency = *std::max_element(latenciesUs.begin(), latenciesUs.end());
+
+    SENDLOG(Info, "HeadlessBenchmark spsc_stress passed %u items in %.3fs, %.2f million items per second, %s\n", settings.itemsCount, seconds, itemsPerSecond / 1'000'000.0, isPinned ? "threads are pinned to cores 0 and 1" : "threads aren't pinned");
+    SENDLOG(Info, "HeadlessBenchmark spsc_stress latency p50 %.3fus, p99 %.3fus, p99.9 %.3fus, max %.3fus, high watermark %u of %u\n", p50, p99, p999, maxLatency, (ui32)buffer->high_watermark(), (ui32)buffer->MaxElements);
+    if (outOfOrderCount)
+    {
+        SENDLOG(Error, "HeadlessBenchmark spsc_stress received %u items out of order\n", outOfOrderCount);
+    }
+
+    const Metric metrics[] =
+    {
+        {"items", (f64)settings.itemsCount},
+        {"seconds", seconds},
+        {"items_per_second", itemsPerSecond},
+        {"latency_p50_us", p50},
+        {"latency_p99_us", p99},
+        {"latency_p999_us", p999},
+        {"latency_max_us", maxLatency},
+        {"high_watermark", (f64)buffer->high_watermark()},
+    };
+    return WriteMetricsReport(settings, metrics) && outOfOrderCount == 0;
+}
\ No newline at end of file
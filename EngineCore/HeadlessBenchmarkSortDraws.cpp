@@ -0,0 +1,32 @@
+#include "BasicHeader.hpp"
+#include "HeadlessBenchmarkModes.hpp"
+
+using namespace EngineCore;
+
+auto HeadlessBenchmark::SortSyntheticDraws(ui32 drawsCount, ui32 frame, vector<RendererDrawQueue::SortEntry> &entries, vector<RendererDrawQueue::SortEntry> &scratch) -> SortResult
+{
+    constexpr ui32 renderTargetsCount = 2, shadersCount = 16, pipelineStatesCount = 32, materialsCount = 512;
+
+    ui32 state = 0x9E3779B9u ^ frame;
+    auto random = [&state]
+    {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    };
+
+    entries.resize(drawsCount);
+    for (ui32 index = 0; index < drawsCount; ++index)
+    {
+        ui32 material = random() % materialsCount;
+        f32 depth = (f32)(random() & 0xFFFF) / 65535.0f;
+        entries[index] = {RendererDrawQueue::Key(0, random() % renderTargetsCount, material % shadersCount, material % pipelineStatesCount, material, depth), index};
+    }
+
+    SortResult result;
+    result.stateChangesUnsorted = RendererDrawQueue::CountStateChanges(entries);
+    auto sortStart = TimeMoment::Now();
+    RendererDrawQueue::RadixSort(entries, scratch);
+    result.sortMs = (TimeMoment::Now() - sortStart).ToSec_f64() * 1000.0;
+    result.stateChangesSorted = RendererDrawQueue::CountStateChanges(entries);
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "BasicHeader.hpp"
+#include "HeadlessBenchmarkModes.hpp"
+#include "Logger.hpp"
+#include "ShadersManager.hpp"
+#include <SystemUniforms.hpp>
+
+using namespace EngineCore;
+
+namespace
+{
+    // stand-ins for glUniform* with the same shape as ShaderBackendData's, they only read a value, so the measured time is mostly the setup's own
+    struct StubUniform
+    {
+        i32 location;
+        uiw setFuncAddress;
+    };
+    using StubSetMatrixUniformFunction = void (*)(i32 location, i32 count, bool transpose, const f32 *values);
+    using StubSetUniformFunction = void (*)(i32 location, i32 count, const void *values);
+    using StubSystemUniforms = array<StubUniform, (uiw)Shader::SystemUniformSlot::_size>;
+
+    volatile f32 UniformsSink;
+
+    void StubSetMatrixUniform(i32 location, i32 count, bool, const f32 *values)
+    {
+        UniformsSink = values[(uiw)(location + count) % 3];
+    }
+
+    void StubSetUniform(i32 location, i32 count, const void *values)
+    {
+        UniformsSink = ((const f32 *)values)[(uiw)(location + count) % 3];
+    }
+
+    const Shader::Uniform AllSystemUniforms[] =
+    {
+        Shader::Uniform{"_ModelMatrix", 3, 4, 1, Shader::Uniform::Type::F32},
+        Shader::Uniform{"_ViewMatrix", 3, 4, 1, Shader::Uniform::Type::F32},
+        Shader::Uniform{"_ProjectionMatrix", 4, 4, 1, Shader::Uniform::Type::F32},
+        Shader::Uniform{"_ViewProjectionMatrix", 4, 4, 1, Shader::Uniform::Type::F32},
+        Shader::Uniform{"_CameraPosition", 3, 1, 1, Shader::Uniform::Type::F32},
+        Shader::Uniform{"_CameraForwardVector", 3, 1, 1, Shader::Uniform::Type::F32},
+        Shader::Uniform{"_CameraRightVector", 3, 1, 1, Shader::Uniform::Type::F32},
+        Shader::Uniform{"_CameraUpVector", 3, 1, 1, Shader::Uniform::Type::F32}
+    };
+
+    StubUniform StubFor(const Shader::Uniform &uniform, uiw index)
+    {
+        return {(i32)index, uniform.elementHeight > 1 ? (uiw)&StubSetMatrixUniform : (uiw)&StubSetUniform};
+    }
+
+    // the slot table ShaderBackendData resolves when a program is linked
+    StubSystemUniforms ResolveSystemUniforms(span<const Shader::Uniform> systemUniforms)
+    {
+        StubSystemUniforms table{};
+        for (uiw index = 0; index < systemUniforms.size(); ++index)
+        {
+            if (auto slot = Shader::FindSystemUniformSlot(systemUniforms[index].name))
+            {
+                table[(uiw)*slot] = StubFor(systemUniforms[index], index);
+            }
+        }
+        return table;
+    }
+
+    // the setup DrawGeneric had before the slot table, every system uniform is searched by name and the camera dependent values are recomputed on every draw
+    void SetSystemUniformsByName(span<const Shader::Uniform> systemUniforms, span<const StubUniform> oglUniforms, const Vector3 &cameraPos, const Matrix4x3 &viewMatrix, const Matrix4x4 &projMatrix, const Matrix4x3 &modelMatrix)
+    {
+        auto setSystemUniform = [systemUniforms, oglUniforms](string_view name, const auto &value)
+        {
+            auto searchResult = std::find_if(systemUniforms.begin(), systemUniforms.end(), [name](const Shader::Uniform &uniform) { return uniform.name == name; });
+            if (searchResult == systemUniforms.end())
+            {
+                return;
+            }
+            const auto &oglUniform = oglUniforms[searchResult - systemUniforms.begin()];
+            if (searchResult->elementHeight > 1)
+            {
+                reinterpret_cast<StubSetMatrixUniformFunction>(oglUniform.setFuncAddress)(oglUniform.location, 1, false, value.Data().data());
+            }
+            else
+            {
+                reinterpret_cast<StubSetUniformFunction>(oglUniform.setFuncAddress)(oglUniform.location, 1, value.Data().data());
+            }
+        };
+
+        Matrix4x4 viewProjMatrix = viewMatrix * projMatrix;
+        Vector3 forwardVector = viewMatrix.GetColumn(2).ToVector3();
+        Vector3 rightVector = viewMatrix.GetColumn(0).ToVector3();
+        Vector3 upVector = viewMatrix.GetColumn(1).ToVector3();
+
+        setSystemUniform("_ModelMatrix", modelMatrix);
+        setSystemUniform("_ViewMatrix", viewMatrix);
+        setSystemUniform("_ProjectionMatrix", projMatrix);
+        setSystemUniform("_ViewProjectionMatrix", viewProjMatrix);
+        setSystemUniform("_CameraPosition", cameraPos);
+        setSystemUniform("_CameraForwardVector", forwardVector);
+        setSystemUniform("_CameraRightVector", rightVector);
+        setSystemUniform("_CameraUpVector", upVector);
+    }
+
+    struct UniformsResult
+    {
+        f64 byNameNs; // per draw
+        f64 slotsNs;
+    };
+
+    // the camera stays the same for all the draws, like it does for a camera's draws within a frame
+    UniformsResult MeasureSystemUniforms(span<const Shader::Uniform> systemUniforms, ui32 drawsCount)
+    {
+        vector<StubUniform> oglUniforms;
+        for (uiw index = 0; index < systemUniforms.size(); ++index)
+        {
+            oglUniforms.push_back(StubFor(systemUniforms[index], index));
+        }
+        StubSystemUniforms table = ResolveSystemUniforms(systemUniforms);
+
+        Vector3 cameraPos(5, 50, -75);
+        Matrix4x3 viewMatrix, modelMatrix;
+        Matrix4x4 projMatrix;
+
+        OGLRenderer::CameraConstants cameraConstants;
+        cameraConstants.position = cameraPos;
+        cameraConstants.viewMatrix = viewMatrix;
+        cameraConstants.projMatrix = projMatrix;
+        cameraConstants.viewProjMatrix = viewMatrix * projMatrix;
+        cameraConstants.forwardVector = viewMatrix.GetColumn(2).ToVector3();
+        cameraConstants.rightVector = viewMatrix.GetColumn(0).ToVector3();
+        cameraConstants.upVector = viewMatrix.GetColumn(1).ToVector3();
+
+        auto byNameStart = TimeMoment::Now();
+        for (ui32 draw = 0; draw < drawsCount; ++draw)
+        {
+            SetSystemUniformsByName(systemUniforms, oglUniforms, cameraPos, viewMatrix, projMatrix, modelMatrix);
+        }
+        auto slotsStart = TimeMoment::Now();
+        for (ui32 draw = 0; draw < drawsCount; ++draw)
+        {
+            OGLRenderer::SetSystemUniforms<StubSetMatrixUniformFunction, StubSetUniformFunction>(table, cameraConstants, &modelMatrix);
+        }
+        auto slotsEnd = TimeMoment::Now();
+
+        return {(slotsStart - byNameStart).ToSec_f64() * 1e9 / drawsCount, (slotsEnd - slotsStart).ToSec_f64() * 1e9 / drawsCount};
+    }
+}
+
+bool HeadlessBenchmark::RunSystemUniforms(const Settings &settings)
+{
+    auto descriptions = ShadersManager::BuiltinDescriptions();
+    auto colored = std::find_if(descriptions.begin(), descriptions.end(), [](const ShaderPackage::ShaderDescription &description) { return description.name == "Colored3DVertices"; });
+    ASSUME(colored != descriptions.end());
+
+    UniformsResult typical = MeasureSystemUniforms(colored->systemUniforms, settings.itemsCount);
+    UniformsResult all = MeasureSystemUniforms(AllSystemUniforms, settings.itemsCount);
+
+    SENDLOG(Info, "HeadlessBenchmark system_uniforms with the %u system uniforms of Colored3DVertices: search by name %.2fns, slot table %.2fns per draw\n", (ui32)colored->systemUniforms.size(), typical.byNameNs, typical.slotsNs);
+    SENDLOG(Info, "HeadlessBenchmark system_uniforms with all %u system uniforms: search by name %.2fns, slot table %.2fns per draw\n", (ui32)std::size(AllSystemUniforms), all.byNameNs, all.slotsNs);
+
+    const Metric metrics[] =
+    {
+        {"draws", (f64)settings.itemsCount},
+        {"typical_by_name_ns", typical.byNameNs},
+        {"typical_slots_ns", typical.slotsNs},
+        {"all_by_name_ns", all.byNameNs},
+        {"all_slots_ns", all.slotsNs},
+    };
+    return WriteMetricsReport(settings, metrics);
+}
\ No newline at end of file
@@ -0,0 +1,777 @@
+#include "BasicHeader.hpp"
+#include "HeadlessChecks.hpp"
+#include "Application.hpp"
+#include "Logger.hpp"
+#include "Camera.hpp"
+#include "Material.hpp"
+#include "NullRenderer.hpp"
+#include "RendererArray.hpp"
+#include "RendererPipelineState.hpp"
+#include "Shader.hpp"
+#include "ShaderPackage.hpp"
+#include "ShadersManager.hpp"
+#include "RendererCommandBuffer.hpp"
+#include "KeyController.hpp"
+#include "RecordingKeyController.hpp"
+#include "ControlActionsLog.hpp"
+#include "AllocationsCounter.hpp"
+#include <ShaderCompileQueue.hpp>
+#include <ProgramBinaryCache.hpp>
+
+using namespace EngineCore;
+
+namespace
+{
+    const char *CurrentCheck = "";
+    ui32 FailedExpectationsCount = 0;
+
+    void Expect(bool condition, const char *description)
+    {
+        if (!condition)
+        {
+            SENDLOG(Error, "HeadlessChecks %s: expected %s\n", CurrentCheck, description);
+            ++FailedExpectationsCount;
+        }
+    }
+
+    // the frontend objects a draw needs, they must be destroyed before the renderer
+    struct DrawObjects
+    {
+        shared_ptr<Camera> camera = Camera::New();
+        shared_ptr<Shader> shader = Application::LoadResource<Shader>("Colored3DVertices");
+        shared_ptr<Material> material = Material::New(shader);
+        shared_ptr<RendererPipelineState> pipelineState = RendererPipelineState::New(shader);
+    };
+
+    // the renderer keeps the bound arrays and the recording alive, they must be released while the renderer is still set, because arrays notify it when deleted
+    void ReleaseArrays(NullRenderer &renderer)
+    {
+        renderer.BindVertexArray(nullptr, 0);
+        renderer.BindIndexArray(nullptr);
+        renderer.BeginFrame();
+        renderer.EndFrame();
+    }
+
+    void IndirectDrawsAreRecordedAsOneCommand()
+    {
+        constexpr ui32 drawsCount = 16;
+
+        auto renderer = NullRenderer::New();
+        Application::SetRenderer(renderer);
+        renderer->IsRecordingCommands(true);
+        {
+            DrawObjects objects;
+            auto indexArray = RendererIndexArray::New(RendererArrayData<ui16>{0, 1, 2, 2, 1, 3});
+
+            array<RendererIndirectDraw, drawsCount> draws;
+            for (ui32 index = 0; index < drawsCount; ++index)
+            {
+                draws[index] = {index % 2 ? 6u : 3u, 1, 0, 0, index};
+            }
+
+            renderer->BeginFrame();
+            renderer->BindIndexArray(indexArray);
+            renderer->DrawIndexedIndirectWithCamera(objects.camera.get(), nullptr, objects.pipelineState.get(), objects.material.get(), PrimitiveTopology::TriangleEnumeration, draws);
+            renderer->EndFrame();
+
+            const auto &recorded = renderer->RecordedCommands();
+            ui32 indirectCommandsCount = 0;
+            for (const auto &command : recorded.Commands())
+            {
+                if (command.type == RendererCommandBuffer::CommandType::DrawIndexedIndirect)
+                {
+                    ++indirectCommandsCount;
+                    Expect(command.count == drawsCount && command.instanceCount == 0, "the indirect command to carry all the draws");
+                    auto recordedDraws = recorded.IndirectDraws().subspan(command.firstIndirectDraw, command.count);
+                    Expect(recordedDraws.size() == drawsCount && recordedDraws.back().baseInstance == drawsCount - 1 && recordedDraws.back().numIndexes == 6, "the recorded draws to match the submitted ones");
+                }
+                Expect(command.type != RendererCommandBuffer::CommandType::Draw && command.type != RendererCommandBuffer::CommandType::DrawIndexed, "no separate draw commands");
+            }
+            Expect(indirectCommandsCount == 1, "a single indirect command");
+
+            const auto &counters = renderer->FrameCounters();
+            Expect(counters.indirectDraws == 1 && counters.draws == 0 && counters.indexedDraws == 0, "a single indirect draw call");
+
+            ReleaseArrays(*renderer);
+        }
+        Application::SetRenderer(nullptr);
+    }
+
+    // buffers recorded in parallel must produce the same draws as if they were issued on the renderer in the submission order
+    void CommandBuffersRecordedOnTwoThreadsAreSubmittedInOrder()
+    {
+        constexpr ui32 drawsPerBuffer = 8;
+
+        auto renderer = NullRenderer::New();
+        Application::SetRenderer(renderer);
+        renderer->IsRecordingCommands(true);
+        {
+            DrawObjects objects;
+            auto secondMaterial = Material::New(objects.shader);
+            auto vertexArray = RendererVertexArray::New(RendererArrayData<Vector3>{{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {1, 1, 0}});
+            auto indexArray = RendererIndexArray::New(RendererArrayData<ui16>{0, 1, 2, 2, 1, 3});
+
+            array<Matrix4x3, drawsPerBuffer * 2> modelMatrices;
+            for (ui32 index = 0; index < modelMatrices.size(); ++index)
+            {
+                modelMatrices[index] = Matrix4x3::CreateRTS(optional<Vector3>{}, Vector3((f32)index, 0, 0));
+            }
+
+            auto record = [&](RendererCommandBuffer &buffer, const Material *material, ui32 firstMatrix)
+            {
+                buffer.SetCamera(objects.camera.get());
+                buffer.SetPipelineState(objects.pipelineState.get());
+                buffer.SetMaterial(material);
+                buffer.BindVertexArray(vertexArray, 0);
+                buffer.BindIndexArray(indexArray);
+                for (ui32 index = 0; index < drawsPerBuffer; ++index)
+                {
+                    buffer.DrawIndexed(&modelMatrices[firstMatrix + index], PrimitiveTopology::TriangleEnumeration, index % 2 ? 6 : 3);
+                }
+                buffer.Draw(nullptr, PrimitiveTopology::TriangleEnumeration, 3);
+            };
+
+            RendererCommandBuffer buffers[2];
+            std::thread firstRecorder([&] { record(buffers[0], objects.material.get(), 0); });
+            std::thread secondRecorder([&] { record(buffers[1], secondMaterial.get(), drawsPerBuffer); });
+            firstRecorder.join();
+            secondRecorder.join();
+
+            const RendererCommandBuffer *submitted[] = {&buffers[0], &buffers[1]};
+            renderer->BeginFrame();
+            renderer->SubmitCommandBuffers(submitted);
+            renderer->EndFrame();
+
+            using CommandType = RendererCommandBuffer::CommandType;
+            auto isDraw = [](const RendererCommandBuffer::Command &command)
+            {
+                return command.type == CommandType::Draw || command.type == CommandType::DrawIndexed || command.type == CommandType::DrawIndexedIndirect;
+            };
+            auto modelMatrixOf = [](const RendererCommandBuffer &buffer, const RendererCommandBuffer::Command &command) -> const Matrix4x3 *
+            {
+                return command.index == RendererCommandBuffer::NoIndex ? nullptr : &buffer.ModelMatrices()[command.index];
+            };
+            // the indexes of indirect draws are local to a buffer, so the draws themselves are compared
+            auto indirectDrawsOf = [](const RendererCommandBuffer &buffer, const RendererCommandBuffer::Command &command)
+            {
+                return command.type == CommandType::DrawIndexedIndirect ? buffer.IndirectDraws().subspan(command.firstIndirectDraw, command.count) : span<const RendererIndirectDraw>{};
+            };
+
+            // the renderer records state only when it changes, so only the draws are compared one to one
+            vector<pair<const RendererCommandBuffer *, const RendererCommandBuffer::Command *>> expectedDraws;
+            for (const auto &buffer : buffers)
+            {
+                for (const auto &command : buffer.Commands())
+                {
+                    if (isDraw(command))
+                    {
+                        expectedDraws.emplace_back(&buffer, &command);
+                    }
+                }
+            }
+
+            const auto &recorded = renderer->RecordedCommands();
+            ui32 drawIndex = 0, materialChangesCount = 0;
+            bool isMatching = true;
+            for (const auto &command : recorded.Commands())
+            {
+                if (command.type == CommandType::SetMaterial)
+                {
+                    Expect(command.object == (materialChangesCount ? (const void *)secondMaterial.get() : objects.material.get()), "the materials to follow the submission order");
+                    ++materialChangesCount;
+                }
+                if (!isDraw(command))
+                {
+                    continue;
+                }
+                if (drawIndex == expectedDraws.size())
+                {
+                    isMatching = false;
+                    break;
+                }
+                const auto &[expectedBuffer, expected] = expectedDraws[drawIndex++];
+                const Matrix4x3 *expectedMatrix = modelMatrixOf(*expectedBuffer, *expected);
+                const Matrix4x3 *recordedMatrix = modelMatrixOf(recorded, command);
+                isMatching &= command.type == expected->type && command.topology == expected->topology && command.count == expected->count && command.instanceCount == expected->instanceCount;
+                isMatching &= (expectedMatrix == nullptr) == (recordedMatrix == nullptr);
+                isMatching &= expectedMatrix == nullptr || recordedMatrix == nullptr || std::memcmp(expectedMatrix, recordedMatrix, sizeof(Matrix4x3)) == 0;
+                auto expectedIndirectDraws = indirectDrawsOf(*expectedBuffer, *expected);
+                auto recordedIndirectDraws = indirectDrawsOf(recorded, command);
+                isMatching &= expectedIndirectDraws.size() == recordedIndirectDraws.size() && (expectedIndirectDraws.empty() || std::memcmp(expectedIndirectDraws.data(), recordedIndirectDraws.data(), expectedIndirectDraws.size_bytes()) == 0);
+            }
+            Expect(isMatching && drawIndex == expectedDraws.size(), "the recorded draws to match the buffers' draws in order");
+            Expect(materialChangesCount == 2, "a material change per buffer");
+
+            const auto &counters = renderer->FrameCounters();
+            Expect(counters.indexedDraws == drawsPerBuffer * 2 && counters.draws == 2 && counters.indirectDraws == 0, "every buffer's draws to be issued");
+            Expect(counters.vertexArrayBinds == 1 && counters.indexArrayBinds == 1, "the repeated bindings of the second buffer to be skipped");
+
+            ReleaseArrays(*renderer);
+        }
+        Application::SetRenderer(nullptr);
+    }
+
+    // compilations complete on the first poll, shaders named fail_begin can't be started, shaders named fail_finish fail to compile
+    class MockShaderCompileBackend : public OGLRenderer::ShaderCompileQueue::Backend
+    {
+        struct Compilation
+        {
+            const Shader *shader{};
+            bool isPolled = false;
+            bool isFinished = false;
+        };
+        vector<Compilation> _compilations{};
+
+    public:
+        ui32 begunCount = 0, finishedCount = 0;
+        ui32 blockingFinishesCount = 0; // finished without being polled as complete first
+        ui32 repeatedBeginsCount = 0;
+
+        virtual bool BeginCompilation(const Shader &shader) override
+        {
+            if (shader.Name() == "fail_begin")
+            {
+                return false;
+            }
+            if (Find(shader))
+            {
+                ++repeatedBeginsCount;
+            }
+            _compilations.push_back({&shader});
+            ++begunCount;
+            return true;
+        }
+
+        virtual bool IsCompilationComplete(const Shader &shader) override
+        {
+            Compilation *compilation = Find(shader);
+            Expect(compilation && !compilation->isFinished, "only started compilations to be polled");
+            if (compilation)
+            {
+                compilation->isPolled = true;
+            }
+            return true;
+        }
+
+        virtual bool FinishCompilation(const Shader &shader) override
+        {
+            Compilation *compilation = Find(shader);
+            Expect(compilation && !compilation->isFinished, "every compilation to be finished once");
+            if (compilation)
+            {
+                blockingFinishesCount += !compilation->isPolled;
+                compilation->isFinished = true;
+            }
+            ++finishedCount;
+            return shader.Name() != "fail_finish";
+        }
+
+        bool IsBegun(const Shader &shader)
+        {
+            return Find(shader) != nullptr;
+        }
+
+    private:
+        Compilation *Find(const Shader &shader)
+        {
+            auto it = std::find_if(_compilations.begin(), _compilations.end(), [&shader](const Compilation &compilation) { return compilation.shader == &shader; });
+            return it != _compilations.end() ? &*it : nullptr;
+        }
+    };
+
+    // the compilation itself needs a GL context, so the scheduling is checked against a mock backend
+    void ShaderCompileQueueSchedulesCompilations()
+    {
+        auto newShader = [](string_view name) { return shared_ptr<const Shader>(Shader::New(name, "", "")); };
+
+        MockShaderCompileBackend backend;
+        OGLRenderer::ShaderCompileQueue queue(backend, 2);
+
+        array<shared_ptr<const Shader>, 6> shaders{newShader("a"), newShader("b"), newShader("c"), newShader("d"), newShader("fail_begin"), newShader("fail_finish")};
+        for (const auto &shader : shaders)
+        {
+            queue.Enqueue(shader);
+        }
+        queue.Enqueue(shaders[0]);
+        Expect(queue.QueuedCount() == 6 && queue.IsQueued(*shaders[0]), "a repeated Enqueue to be ignored");
+
+        queue.Update();
+        Expect(backend.begunCount == 2 && backend.finishedCount == 0, "the first Update to only start maxStartedPerUpdate compilations");
+
+        queue.Enqueue(shaders[1]);
+        queue.Update();
+        Expect(backend.begunCount == 4 && backend.finishedCount == 2, "the second Update to finish the complete compilations and start the next ones");
+        Expect(queue.QueuedCount() == 4 && !queue.IsQueued(*shaders[0]), "finished shaders to leave the queue");
+
+        queue.Update();
+        Expect(backend.begunCount == 5 && backend.finishedCount == 4 && queue.FailedCount() == 1, "a compilation that couldn't be started to count as failed");
+        Expect(queue.QueuedCount() == 1 && !queue.IsQueued(*shaders[4]), "a compilation that couldn't be started to leave the queue");
+        Expect(backend.blockingFinishesCount == 0, "Update to never block on an incomplete compilation");
+
+        // fail_finish is expected to log a compilation error
+        queue.Flush();
+        Expect(backend.finishedCount == 5 && queue.FailedCount() == 2 && queue.QueuedCount() == 0, "Flush to finish everything and count the failed compilation");
+        Expect(backend.blockingFinishesCount == 1, "Flush to finish the started compilation without polling");
+
+        array<shared_ptr<const Shader>, 3> dropped{newShader("g"), newShader("h"), newShader("i")};
+        for (const auto &shader : dropped)
+        {
+            queue.Enqueue(shader);
+        }
+        queue.Update();
+        queue.Clear();
+        Expect(backend.begunCount == 7 && backend.finishedCount == 7, "Clear to finish the started compilations");
+        Expect(queue.QueuedCount() == 0 && !backend.IsBegun(*dropped[2]), "Clear to drop the waiting shaders without starting them");
+
+        queue.Enqueue(dropped[2]);
+        Expect(queue.QueuedCount() == 1, "a dropped shader to be accepted again");
+        queue.Clear();
+
+        Expect(backend.repeatedBeginsCount == 0, "no shader to be started twice");
+        Expect(queue.FailedCount() == 2, "only the two failures to be counted");
+    }
+
+    bool AreUniformsEqual(const Shader::Uniform &left, const Shader::Uniform &right)
+    {
+        return left.name == right.name && left.elementWidth == right.elementWidth && left.elementHeight == right.elementHeight && left.elementsCount == right.elementsCount &&
+            left.type == right.type && left.condition.required == right.condition.required && left.condition.excluded == right.condition.excluded;
+    }
+
+    vector<ui8> SerializeBuiltinShaders()
+    {
+        ShaderPackage::Builder builder;
+        for (const auto &description : ShadersManager::BuiltinDescriptions())
+        {
+            Expect(builder.Add(description), "the built-in shader names to be unique");
+        }
+        return builder.Serialize();
+    }
+
+    void ShaderPackageRoundTripsBuiltinShaders()
+    {
+        auto data = SerializeBuiltinShaders();
+        auto reader = ShaderPackage::Reader::FromMemory(data.data(), data.size());
+        Expect(reader != nullptr, "the serialized package to be valid");
+        if (reader == nullptr)
+        {
+            return;
+        }
+
+        auto descriptions = ShadersManager::BuiltinDescriptions();
+        Expect(reader->Index().size() == descriptions.size(), "the package to have every built-in shader");
+        Expect(reader->Find("NoSuchShader") == nullptr, "a missing shader not to be found");
+
+        for (const auto &description : descriptions)
+        {
+            const auto *record = reader->Find(description.name);
+            Expect(record != nullptr, "every built-in shader to be found by name");
+            if (record == nullptr)
+            {
+                continue;
+            }
+
+            Expect(reader->String(record->name) == description.name, "the name to round-trip");
+            Expect(reader->String(record->vsCode) == description.vsCode && reader->String(record->psCode) == description.psCode, "the code to round-trip");
+
+            auto areUniformsEqual = [&reader](span<const ShaderPackage::UniformRecord> records, span<const Shader::Uniform> uniforms)
+            {
+                return records.size() == uniforms.size() && std::equal(records.begin(), records.end(), uniforms.begin(),
+                    [&reader](const ShaderPackage::UniformRecord &record, const Shader::Uniform &uniform) { return AreUniformsEqual(reader->Uniform(record), uniform); });
+            };
+            Expect(areUniformsEqual(reader->Uniforms(*record), description.uniforms), "the uniforms to round-trip");
+            Expect(areUniformsEqual(reader->SystemUniforms(*record), description.systemUniforms), "the system uniforms to round-trip");
+
+            auto attributes = reader->InputAttributes(*record);
+            bool areAttributesEqual = attributes.size() == description.inputAttributes.size();
+            for (uiw index = 0; areAttributesEqual && index < attributes.size(); ++index)
+            {
+                ShaderVariantCondition condition = description.inputAttributesConditions.empty() ? ShaderVariantCondition{} : description.inputAttributesConditions[index];
+                areAttributesEqual = reader->String(attributes[index].name) == description.inputAttributes[index] &&
+                    attributes[index].condition.required == condition.required && attributes[index].condition.excluded == condition.excluded;
+            }
+            Expect(areAttributesEqual, "the input attributes and their conditions to round-trip");
+
+            auto keywords = reader->Keywords(*record);
+            Expect(keywords.size() == description.keywords.size() && std::equal(keywords.begin(), keywords.end(), description.keywords.begin(),
+                [&reader](ShaderPackage::StringRef keyword, string_view name) { return reader->String(keyword) == name; }), "the keywords to round-trip");
+        }
+    }
+
+    void ShaderPackageRejectsDamagedData()
+    {
+        const auto data = SerializeBuiltinShaders();
+        Expect(ShaderPackage::Reader::FromMemory(data.data(), data.size()) != nullptr, "the intact package to be valid");
+
+        for (uiw size : {(uiw)0, sizeof(ShaderPackage::Header) - 1, sizeof(ShaderPackage::Header), data.size() / 2, data.size() - 8})
+        {
+            Expect(ShaderPackage::Reader::FromMemory(data.data(), size) == nullptr, "a truncated package to be rejected");
+        }
+
+        // the header is patched to match the truncated size, so only the bounds checks can catch it
+        auto truncated = data;
+        truncated.resize(data.size() / 2 & ~(uiw)7);
+        ((ShaderPackage::Header *)truncated.data())->fileSize = (ui32)truncated.size();
+        Expect(ShaderPackage::Reader::FromMemory(truncated.data(), truncated.size()) == nullptr, "a truncated package with a consistent header to be rejected");
+
+        auto isRejectedAfter = [&data](auto &&corrupt)
+        {
+            auto corrupted = data;
+            corrupt(corrupted.data());
+            return ShaderPackage::Reader::FromMemory(corrupted.data(), corrupted.size()) == nullptr;
+        };
+        auto firstEntry = [](ui8 *file) { return (ShaderPackage::IndexEntry *)(file + sizeof(ShaderPackage::Header)); };
+        auto firstRecord = [&firstEntry](ui8 *file) { return (ShaderPackage::ShaderRecord *)(file + firstEntry(file)->recordOffset); };
+
+        Expect(isRejectedAfter([](ui8 *file) { ((ShaderPackage::Header *)file)->signature = 0; }), "a wrong signature to be rejected");
+        Expect(isRejectedAfter([](ui8 *file) { ((ShaderPackage::Header *)file)->version += 1; }), "an unknown version to be rejected");
+        Expect(isRejectedAfter([](ui8 *file) { ((ShaderPackage::Header *)file)->shadersCount = ~0u; }), "a shaders count past the end to be rejected");
+        Expect(isRejectedAfter([&firstEntry](ui8 *file) { firstEntry(file)->nameHash ^= 1; }), "a name hash that doesn't match the name to be rejected");
+        Expect(isRejectedAfter([&firstEntry](ui8 *file) { firstEntry(file)->recordOffset += 4; }), "a misaligned record to be rejected");
+        Expect(isRejectedAfter([&firstEntry](ui8 *file) { firstEntry(file)->name.length = ~0u; }), "a name past the end to be rejected");
+        Expect(isRejectedAfter([&firstRecord](ui8 *file) { firstRecord(file)->vsCode.offset = ~0u; }), "code past the end to be rejected");
+        Expect(isRejectedAfter([&firstRecord](ui8 *file) { firstRecord(file)->uniformsCount = ~0u; }), "a uniforms table past the end to be rejected");
+        Expect(isRejectedAfter([&firstRecord](ui8 *file) { firstRecord(file)->keywordsCount = Shader::MaxKeywords + 1; }), "too many keywords to be rejected");
+    }
+
+    // the file is never created, so the caches start empty
+    FilePath MissingProgramBinaryCachePath()
+    {
+        return FilePath::FromChar("headless_checks_missing_program_binaries.bin");
+    }
+
+    void ProgramBinaryCacheRoundTrips()
+    {
+        OGLRenderer::ProgramBinaryCache cache(MissingProgramBinaryCachePath(), "driver A");
+        Expect(cache.IsEnabled() && cache.Size() == 0, "a cache without a file to be enabled and empty");
+
+        ui64 key = cache.Key("vs", "ps");
+        Expect(key != cache.Key("vsps", "") && key != cache.Key("", "vsps") && key != cache.Key("v", "sps") && key != cache.Key("ps", "vs"), "the key to change when code moves between VS and PS");
+        Expect(key != OGLRenderer::ProgramBinaryCache(MissingProgramBinaryCachePath(), "driver B").Key("vs", "ps"), "the key to depend on the driver");
+
+        ui64 emptyKey = cache.Key("empty vs", "empty ps");
+        cache.Store(key, 0x8E21, {1, 2, 3, 4, 5});
+        cache.Store(emptyKey, 7, {});
+        auto data = cache.Serialize();
+
+        OGLRenderer::ProgramBinaryCache loaded(MissingProgramBinaryCachePath(), "driver A");
+        Expect(loaded.Deserialize(data.data(), data.size()) && loaded.Size() == 2, "the serialized cache to be loaded with every binary");
+
+        const ui8 expected[] = {1, 2, 3, 4, 5};
+        auto binary = loaded.Find(key);
+        Expect(binary && binary->format == 0x8E21 && binary->data.size() == std::size(expected) && std::equal(binary->data.begin(), binary->data.end(), expected), "the binary and its format to round-trip");
+        auto emptyBinary = loaded.Find(emptyKey);
+        Expect(emptyBinary && emptyBinary->format == 7 && emptyBinary->data.empty(), "an empty binary to round-trip");
+        Expect(!loaded.Find(cache.Key("ps", "vs")), "a key that wasn't stored not to be found");
+    }
+
+    void ProgramBinaryCacheRejectsForeignAndTruncatedData()
+    {
+        OGLRenderer::ProgramBinaryCache cache(MissingProgramBinaryCachePath(), "driver A");
+        cache.Store(cache.Key("vs", "ps"), 1, {1, 2, 3, 4, 5, 6, 7, 8});
+        cache.Store(cache.Key("vs2", "ps2"), 2, {9});
+        auto data = cache.Serialize();
+
+        OGLRenderer::ProgramBinaryCache otherDriver(MissingProgramBinaryCachePath(), "driver B");
+        Expect(!otherDriver.Deserialize(data.data(), data.size()) && otherDriver.Size() == 0, "a cache written by another driver to be rejected");
+
+        OGLRenderer::ProgramBinaryCache loaded(MissingProgramBinaryCachePath(), "driver A");
+        bool isEveryTruncationRejected = true;
+        for (uiw size = 0; size < data.size(); ++size)
+        {
+            // loading the whole data first makes sure a failed load doesn't keep the previous entries either
+            Expect(loaded.Deserialize(data.data(), data.size()), "the intact cache to be loaded");
+            isEveryTruncationRejected &= !loaded.Deserialize(data.data(), size) && loaded.Size() == 0;
+        }
+        Expect(isEveryTruncationRejected, "truncated data to be rejected and to leave the cache empty");
+    }
+
+    ControlAction KeyAction(KeyCode key, DeviceTypes::DeviceType device = DeviceTypes::MouseKeyboard)
+    {
+        return ControlAction{ControlAction::Key{key, ControlAction::Key::KeyState::Pressed}, TimeMoment::Now(), device};
+    }
+
+    void KeyControllerFiltersListenersByDeviceAndKind()
+    {
+        auto keyController = KeyController::New();
+
+        ui32 mouseKeyboardKeys = 0, mouseMoves = 0, touches = 0, joystickKeys = 0, everything = 0;
+        auto counter = [](ui32 &count) { return [&count](const ControlAction &) { ++count; return false; }; };
+        auto mouseKeyboardKeysHandle = keyController->OnControlAction(counter(mouseKeyboardKeys), DeviceTypes::MouseKeyboard, ControlActionKinds::Key);
+        auto mouseMovesHandle = keyController->OnControlAction(counter(mouseMoves), DeviceTypes::MouseKeyboard, ControlActionKinds::MouseMove.Combined(ControlActionKinds::MouseWheel));
+        auto touchesHandle = keyController->OnControlAction(counter(touches), DeviceTypes::_AllTouches, ControlActionKinds::Touch);
+        auto joystickKeysHandle = keyController->OnControlAction(counter(joystickKeys), DeviceTypes::Joystick1, ControlActionKinds::Key);
+        auto everythingHandle = keyController->OnControlAction(counter(everything), DeviceTypes::_AllDevices);
+
+        keyController->Dispatch(KeyAction(KeyCode::Space));
+        keyController->Dispatch(ControlAction{ControlAction::MouseMove{i32Vector2(1, 2)}, TimeMoment::Now(), DeviceTypes::MouseKeyboard});
+        keyController->Dispatch(ControlAction{ControlAction::MouseWheel{1}, TimeMoment::Now(), DeviceTypes::MouseKeyboard});
+        keyController->Dispatch(ControlAction{ControlAction::TouchDown{i32Vector2(3, 4)}, TimeMoment::Now(), DeviceTypes::Touch3});
+        keyController->Dispatch(ControlAction{ControlAction::TouchUp{}, TimeMoment::Now(), DeviceTypes::Touch3});
+        keyController->Dispatch(KeyAction(KeyCode::Space, DeviceTypes::Joystick0));
+        keyController->Dispatch(KeyAction(KeyCode::Space, DeviceTypes::Joystick1));
+
+        Expect(mouseKeyboardKeys == 1, "a key listener not to get moves, wheels and other devices' keys");
+        Expect(mouseMoves == 2, "a listener of two kinds to get both");
+        Expect(touches == 2, "a listener of all touches to get the actions of any of them");
+        Expect(joystickKeys == 1, "a joystick's listener not to get another joystick's keys");
+        Expect(everything == 7, "a listener without masks to get everything");
+
+        keyController->RemoveListener(everythingHandle);
+        keyController->Dispatch(KeyAction(KeyCode::Space));
+        Expect(everything == 7 && mouseKeyboardKeys == 2, "a removed listener to leave every bucket it was in");
+    }
+
+    void KeyControllerHandlesReentrantListeners()
+    {
+        auto keyController = KeyController::New();
+        string calls;
+
+        // listeners are called from the most recent one, so newest goes first and removes the one in the middle before it's called, then itself
+        IKeyController::ListenerHandle oldest, middle, newest;
+        oldest = keyController->OnControlAction([&calls](const ControlAction &) { calls += 'o'; return false; }, DeviceTypes::MouseKeyboard, ControlActionKinds::Key);
+        middle = keyController->OnControlAction([&calls](const ControlAction &) { calls += 'm'; return false; }, DeviceTypes::MouseKeyboard, ControlActionKinds::Key);
+        newest = keyController->OnControlAction([&](const ControlAction &)
+        {
+            calls += 'n';
+            keyController->RemoveListener(middle);
+            keyController->RemoveListener(newest);
+            return false;
+        }, DeviceTypes::MouseKeyboard, ControlActionKinds::Key);
+
+        keyController->Dispatch(KeyAction(KeyCode::Space));
+        Expect(calls == "no", "a listener removed by another one before it's called to be skipped, the rest to be called");
+        calls.clear();
+        keyController->Dispatch(KeyAction(KeyCode::Space));
+        Expect(calls == "o", "listeners removed while dispatching to stay removed");
+        keyController->RemoveListener(oldest);
+
+        // a listener dispatches another key into the same bucket, the nested dispatch reaches every listener before the outer one continues
+        calls.clear();
+        bool isRemovingOuter = false;
+        IKeyController::ListenerHandle outer = keyController->OnControlAction([&calls](const ControlAction &action) { calls += std::get<ControlAction::Key>(action.action).key == KeyCode::Space ? "oS" : "oB"; return false; }, DeviceTypes::MouseKeyboard, ControlActionKinds::Key);
+        IKeyController::ListenerHandle dispatching = keyController->OnControlAction([&](const ControlAction &action)
+        {
+            if (std::get<ControlAction::Key>(action.action).key == KeyCode::Space)
+            {
+                calls += "dS";
+                keyController->Dispatch(KeyAction(KeyCode::MButton0));
+            }
+            else
+            {
+                calls += "dB";
+                if (isRemovingOuter)
+                {
+                    keyController->RemoveListener(outer);
+                }
+            }
+            return false;
+        }, DeviceTypes::MouseKeyboard, ControlActionKinds::Key);
+
+        keyController->Dispatch(KeyAction(KeyCode::Space));
+        Expect(calls == "dSdBoBoS", "a nested dispatch to call every listener and the outer one to continue after it");
+
+        // the nested dispatch removes a listener the outer one hasn't reached yet
+        calls.clear();
+        isRemovingOuter = true;
+        keyController->Dispatch(KeyAction(KeyCode::Space));
+        Expect(calls == "dSdB", "a listener removed by a nested dispatch to be skipped by the outer one");
+        calls.clear();
+        keyController->Dispatch(KeyAction(KeyCode::Space));
+        Expect(calls == "dSdB", "the listener removed by a nested dispatch to stay removed");
+    }
+
+    void ControlActionsLogRoundTrips()
+    {
+        // 0.7us apart, so every delta is rounded, the decoded moments must stay within the rounding error instead of drifting away
+        constexpr ui32 actionsCount = 4000;
+        TimeMoment start = TimeMoment::Now();
+        vector<ControlAction> actions;
+        actions.reserve(actionsCount + 1);
+        for (ui32 index = 0; index < actionsCount; ++index)
+        {
+            TimeMoment moment = start + TimeDifference(index * 0.7e-6);
+            switch (index % 4)
+            {
+            case 0:
+                actions.push_back({ControlAction::Key{KeyCode::Space, index % 8 ? ControlAction::Key::KeyState::Released : ControlAction::Key::KeyState::Pressed}, moment, DeviceTypes::MouseKeyboard});
+                break;
+            case 1:
+                actions.push_back({ControlAction::MouseMove{i32Vector2((i32)index, -(i32)index)}, moment, DeviceTypes::MouseKeyboard});
+                break;
+            case 2:
+                actions.push_back({ControlAction::MouseWheel{-2}, moment, DeviceTypes::MouseKeyboard});
+                break;
+            case 3:
+                actions.push_back({ControlAction::TouchDown{i32Vector2((i32)index, 7)}, moment, DeviceTypes::Touch2});
+                break;
+            }
+        }
+        // goes back in time, so it's stored with zero delta and decoded at the previous action's moment
+        actions.push_back({ControlAction::MouseWheel{1}, start, DeviceTypes::MouseKeyboard});
+
+        vector<ui8> encoded(actions.size() * ControlActionsLog::MaxEncodedActionSize);
+        uiw encodedSize = 0;
+        TimeMoment encodingMoment = start;
+        for (const auto &action : actions)
+        {
+            encodedSize += ControlActionsLog::Encode(action, encodingMoment, encoded.data() + encodedSize);
+        }
+
+        // encoding an action at its own moment gives zero delta, so equal bytes mean equal device, kind and payload
+        auto encodeAlone = [](const ControlAction &action, array<ui8, ControlActionsLog::MaxEncodedActionSize> &target)
+        {
+            TimeMoment moment = action.occuredAt;
+            return ControlActionsLog::Encode(action, moment, target.data());
+        };
+
+        TimeMoment decodingMoment = start, previousDecodedMoment = start;
+        uiw offset = 0;
+        f64 maxErrorUs = 0;
+        bool areActionsEqual = true;
+        for (uiw index = 0; index < actions.size(); ++index)
+        {
+            const auto &original = actions[index];
+            ControlAction decoded;
+            uiw consumed = ControlActionsLog::Decode(encoded.data() + offset, encodedSize - offset, decodingMoment, decoded);
+            if (consumed == 0)
+            {
+                Expect(false, "every encoded action to be decoded");
+                return;
+            }
+            offset += consumed;
+
+            array<ui8, ControlActionsLog::MaxEncodedActionSize> originalBytes, decodedBytes;
+            uiw originalSize = encodeAlone(original, originalBytes), decodedSize = encodeAlone(decoded, decodedBytes);
+            areActionsEqual &= originalSize == decodedSize && std::equal(originalBytes.begin(), originalBytes.begin() + originalSize, decodedBytes.begin());
+
+            if (index + 1 < actions.size())
+            {
+                auto error = decoded.occuredAt > original.occuredAt ? decoded.occuredAt - original.occuredAt : original.occuredAt - decoded.occuredAt;
+                maxErrorUs = std::max(maxErrorUs, error.ToSec_f64() * 1'000'000.0);
+            }
+            else
+            {
+                Expect((decoded.occuredAt - previousDecodedMoment).ToSec_f64() == 0, "an action that goes back in time to be decoded at the previous action's moment");
+            }
+            previousDecodedMoment = decoded.occuredAt;
+        }
+
+        Expect(offset == encodedSize, "the decoding to consume every encoded byte");
+        Expect(areActionsEqual, "devices, kinds and payloads to round-trip");
+        if (maxErrorUs >= 1.0)
+        {
+            SENDLOG(Error, "HeadlessChecks %s: decoded moments are up to %.2fus off\n", CurrentCheck, maxErrorUs);
+        }
+        Expect(maxErrorUs < 1.0, "the decoded moments to stay within the rounding error of the encoded ones");
+    }
+
+    // the per-frame path of the windowed app: actions are queued by the window procedure, then dispatched as spans
+    // through the recording controller into KeyController and its listeners
+    void InputPathDoesntAllocate()
+    {
+        if constexpr (!AllocationsCounter::IsAvailable)
+        {
+            SENDLOG(Info, "HeadlessChecks %s is skipped, the build doesn't define COUNT_ALLOCATIONS\n", CurrentCheck);
+            return;
+        }
+
+        auto keyController = KeyController::New();
+        auto recordingController = RecordingKeyController::New(keyController);
+        Expect(recordingController->StartRecording(FilePath::FromChar("headless_checks_controls.log")), "the recording to start");
+
+        ui32 listenedCount = 0, recordedCount = 0;
+        auto listenerHandle = keyController->OnControlAction([&listenedCount](const ControlAction &) { ++listenedCount; return false; }, DeviceTypes::MouseKeyboard);
+        auto recordingHandle = recordingController->OnRecordingControlAction([&recordedCount](const ControlAction &) { ++recordedCount; return false; });
+
+        ControlsQueue queue;
+        queue.CoalesceMoves(true);
+
+        auto frame = [&queue, &recordingController](ui32 frameIndex)
+        {
+            auto keyState = frameIndex % 2 ? ControlAction::Key::KeyState::Released : ControlAction::Key::KeyState::Pressed;
+            queue.Enqueue(DeviceTypes::MouseKeyboard, ControlAction::Key{KeyCode::Space, keyState});
+            for (i32 move = 0; move < 8; ++move)
+            {
+                queue.Enqueue(DeviceTypes::MouseKeyboard, ControlAction::MouseMove{i32Vector2(move, -move)});
+            }
+            queue.Enqueue(DeviceTypes::MouseKeyboard, ControlAction::MouseWheel{1});
+
+            for (auto actions : queue.Spans())
+            {
+                recordingController->Dispatch(actions);
+            }
+            queue.clear();
+        };
+
+        // the first frame may grow the controllers' internal storage
+        frame(0);
+
+        constexpr ui32 framesCount = 100;
+        AllocationsCounter::Start();
+        for (ui32 frameIndex = 1; frameIndex <= framesCount; ++frameIndex)
+        {
+            frame(frameIndex);
+        }
+        ui32 allocationsCount = AllocationsCounter::Stop();
+
+        if (allocationsCount != 0)
+        {
+            SENDLOG(Error, "HeadlessChecks %s: %u allocations in %u frames\n", CurrentCheck, allocationsCount, framesCount);
+        }
+        Expect(allocationsCount == 0, "no allocations while queueing and dispatching");
+        Expect(listenedCount == (framesCount + 1) * 3, "the key, the coalesced move and the wheel to reach the listener every frame");
+        Expect(recordedCount == listenedCount, "the recording controller to see every dispatched action");
+        Expect(queue.CoalescedCount() == (framesCount + 1) * 7, "the moves to be coalesced");
+
+        recordingController->StopRecording();
+    }
+
+    struct Check
+    {
+        const char *name;
+        void (*function)();
+    };
+
+    const Check Checks[] =
+    {
+        {"InputPathDoesntAllocate", InputPathDoesntAllocate},
+        {"IndirectDrawsAreRecordedAsOneCommand", IndirectDrawsAreRecordedAsOneCommand},
+        {"CommandBuffersRecordedOnTwoThreadsAreSubmittedInOrder", CommandBuffersRecordedOnTwoThreadsAreSubmittedInOrder},
+        {"ShaderCompileQueueSchedulesCompilations", ShaderCompileQueueSchedulesCompilations},
+        {"ShaderPackageRoundTripsBuiltinShaders", ShaderPackageRoundTripsBuiltinShaders},
+        {"ShaderPackageRejectsDamagedData", ShaderPackageRejectsDamagedData},
+        {"ProgramBinaryCacheRoundTrips", ProgramBinaryCacheRoundTrips},
+        {"ProgramBinaryCacheRejectsForeignAndTruncatedData", ProgramBinaryCacheRejectsForeignAndTruncatedData},
+        {"KeyControllerFiltersListenersByDeviceAndKind", KeyControllerFiltersListenersByDeviceAndKind},
+        {"KeyControllerHandlesReentrantListeners", KeyControllerHandlesReentrantListeners},
+        {"ControlActionsLogRoundTrips", ControlActionsLogRoundTrips},
+    };
+}
+
+bool HeadlessChecks::IsRequested(i32 argc, const char *const *argv)
+{
+    return argc >= 2 && string_view(argv[1]) == "-headless_checks";
+}
+
+bool HeadlessChecks::Run()
+{
+    ui32 failedChecksCount = 0;
+    for (const auto &check : Checks)
+    {
+        CurrentCheck = check.name;
+        ui32 failedBefore = FailedExpectationsCount;
+        check.function();
+        if (FailedExpectationsCount == failedBefore)
+        {
+            SENDLOG(Info, "HeadlessChecks %s passed\n", check.name);
+        }
+        else
+        {
+            SENDLOG(Error, "HeadlessChecks %s failed\n", check.name);
+            ++failedChecksCount;
+        }
+    }
+
+    SENDLOG(Info, "HeadlessChecks finished, %u of %u checks failed\n", failedChecksCount, (ui32)std::size(Checks));
+    return failedChecksCount == 0;
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#pragma once
+
+namespace EngineCore::HeadlessChecks
+{
+    // expects -headless_checks
+    [[nodiscard]] bool IsRequested(i32 argc, const char *const *argv);
+
+    // checks CPU-side behavior that doesn't need a window or a GPU, every failure is logged as an error
+    // checks that draw create their own NullRenderer, so Application must be created, but the renderer must not be
+    // returns false if any check has failed
+    bool Run();
+}
\ No newline at end of file
@@ -118,9 +118,41 @@ namespace EngineCore
         ControlAction(TouchZoomEnd actionData, const TimeMoment &occuredAt, DeviceTypes::DeviceType device) : action{actionData}, occuredAt{occuredAt}, device{device} {}
     };
 
+    // listeners may subscribe only to some kinds of actions to not be called for the rest
+    struct ControlActionKinds
+    {
+        static constexpr struct ControlActionKind : EnumCombinable<ControlActionKind, ui32, true>
+        {} _None = ControlActionKind::Create(0),
+            Key = ControlActionKind::Create(1 << 0),
+            MouseMove = ControlActionKind::Create(1 << 1), // includes MouseSetPosition
+            MouseWheel = ControlActionKind::Create(1 << 2),
+            Touch = ControlActionKind::Create(1 << 3), // all touch actions
+            _All = Key.Combined(MouseMove).Combined(MouseWheel).Combined(Touch);
+    };
+
+    inline ControlActionKinds::ControlActionKind ControlActionKindOf(const ControlAction &action)
+    {
+        if (std::holds_alternative<ControlAction::Key>(action.action))
+        {
+            return ControlActionKinds::Key;
+        }
+        if (std::holds_alternative<ControlAction::MouseMove>(action.action) || std::holds_alternative<ControlAction::MouseSetPosition>(action.action))
+        {
+            return ControlActionKinds::MouseMove;
+        }
+        if (std::holds_alternative<ControlAction::MouseWheel>(action.action))
+        {
+            return ControlActionKinds::MouseWheel;
+        }
+        return ControlActionKinds::Touch;
+    }
+
     class ControlsQueue
     {
-        RingBuffer<ControlAction, 256> _actions;
+        // overwriting would silently lose the oldest actions (including key releases), so new actions are rejected instead and counted
+        RingBuffer<ControlAction, 256, RingBufferOverflowPolicy::Reject> _actions;
+        uiw _coalescedCount = 0;
+        bool _isCoalescingMoves = false;
 
     public:
 
@@ -134,18 +166,74 @@ namespace EngineCore
             return _actions.size();
         }
 
-        template <typename T> void Enqueue(DeviceTypes::DeviceType device, T action)
+        static constexpr uiw Capacity()
         {
-            ASSUME(device != DeviceTypes::_None);
-            _actions.push_back(ControlAction{action, TimeMoment::Now(), device});
+            return decltype(_actions)::MaxElements;
+        }
+
+        uiw DroppedCount() const
+        {
+            return _actions.dropped_count();
         }
 
-        std::experimental::generator<ControlAction> Enumerate() const
+        uiw HighWatermark() const
         {
-            for (const auto &action : _actions)
+            return _actions.high_watermark();
+        }
+
+        // high polling rate devices produce a lot of moves per frame, with coalescing enabled a MouseMove, MouseWheel or TouchMove
+        // is merged into the most recently queued action if it has the same type and device, so the order relative to other actions is kept
+        void CoalesceMoves(bool isEnabled)
+        {
+            _isCoalescingMoves = isEnabled;
+        }
+
+        bool IsCoalescingMoves() const
+        {
+            return _isCoalescingMoves;
+        }
+
+        uiw CoalescedCount() const
+        {
+            return _coalescedCount;
+        }
+
+        // returns false if the queue is full and the action has been dropped
+        template <typename T> bool Enqueue(DeviceTypes::DeviceType device, T action)
+        {
+            return EnqueueAt(device, action, TimeMoment::Now());
+        }
+
+        // keeps the action's moment, used to queue actions that have been recorded earlier
+        bool Enqueue(const ControlAction &action)
+        {
+            return std::visit([this, &action](const auto &actionData) { return EnqueueAt(action.device, actionData, action.occuredAt); }, action.action);
+        }
+
+        // the queued actions from the oldest to the newest, pass each part to IKeyController::Dispatch in order
+        array<span<const ControlAction>, 2> Spans() const
+        {
+            return _actions.spans();
+        }
+
+    private:
+        template <typename T> bool EnqueueAt(DeviceTypes::DeviceType device, T action, const TimeMoment &occuredAt)
+        {
+            ASSUME(device != DeviceTypes::_None);
+            if constexpr (std::is_same_v<T, ControlAction::MouseMove> || std::is_same_v<T, ControlAction::MouseWheel> || std::is_same_v<T, ControlAction::TouchMove>)
             {
-                co_yield action;
+                if (_isCoalescingMoves && !_actions.empty() && _actions.back().device == device)
+                {
+                    if (auto *previous = std::get_if<T>(&_actions.back().action))
+                    {
+                        previous->delta += action.delta;
+                        _actions.back().occuredAt = occuredAt;
+                        ++_coalescedCount;
+                        return true;
+                    }
+                }
             }
+            return _actions.try_push(ControlAction{action, occuredAt, device});
         }
     };
 
@@ -174,12 +262,12 @@ namespace EngineCore
 
         virtual ~IKeyController() = default;
         virtual void Dispatch(const ControlAction &action) = 0;
-        virtual void Dispatch(std::experimental::generator<ControlAction> enumerable) = 0;
+        virtual void Dispatch(span<const ControlAction> actions) = 0; // same as dispatching every action in order
         virtual void Update() = 0; // may be used for key repeating
         [[nodiscard]] virtual KeyInfo GetKeyInfo(KeyCode key, DeviceTypes::DeviceType device = DeviceTypes::MouseKeyboard) const = 0; // always default for Touch
         [[nodiscard]] virtual optional<i32Vector2> GetPositionInfo(DeviceTypes::DeviceType device = DeviceTypes::MouseKeyboard) const = 0; // always nullopt for Joystick
         [[nodiscard]] virtual const AllKeyStates &GetAllKeyStates(DeviceTypes::DeviceType device = DeviceTypes::MouseKeyboard) const = 0; // always default for Touch
-        [[nodiscard]] virtual ListenerHandle OnControlAction(const ListenerCallbackType &callback, DeviceTypes::DeviceType deviceMask) = 0;
+        [[nodiscard]] virtual ListenerHandle OnControlAction(const ListenerCallbackType &callback, DeviceTypes::DeviceType deviceMask, ControlActionKinds::ControlActionKind kindMask = ControlActionKinds::_All) = 0;
         virtual void RemoveListener(ListenerHandle &handle) = 0;
     };
 
@@ -202,12 +290,12 @@ namespace EngineCore
 
         virtual ~EmptyKeyController() override = default;
         virtual void Dispatch(const ControlAction &action) override {}
-        virtual void Dispatch(std::experimental::generator<ControlAction> enumerable) override {}
+        virtual void Dispatch(span<const ControlAction> actions) override {}
         virtual void Update() override {}
         [[nodiscard]] virtual KeyInfo GetKeyInfo(KeyCode key, DeviceTypes::DeviceType device = DeviceTypes::MouseKeyboard) const override { return {}; }
         [[nodiscard]] virtual optional<i32Vector2> GetPositionInfo(DeviceTypes::DeviceType device = DeviceTypes::MouseKeyboard) const override { return {}; }
         [[nodiscard]] virtual const AllKeyStates &GetAllKeyStates(DeviceTypes::DeviceType device = DeviceTypes::MouseKeyboard) const override { return _defaultKeyStates; }
-        [[nodiscard]] virtual ListenerHandle OnControlAction(const ListenerCallbackType &callback, DeviceTypes::DeviceType deviceMask) override { return {}; }
+        [[nodiscard]] virtual ListenerHandle OnControlAction(const ListenerCallbackType &callback, DeviceTypes::DeviceType deviceMask, ControlActionKinds::ControlActionKind kindMask = ControlActionKinds::_All) override { return {}; }
         virtual void RemoveListener(ListenerHandle &handle) override {}
 
     private:
@@ -16,12 +16,6 @@ shared_ptr<KeyController> KeyController::New()
 
 void KeyController::Dispatch(const ControlAction &action)
 {
-    if (_isDispatchingInProgress)
-    {
-        SOFTBREAK;
-        return;
-    }
-
     auto cookedAction = action;
     DeviceTypes::DeviceType value = cookedAction.device;
 
@@ -96,30 +90,34 @@ void KeyController::Dispatch(const ControlAction &action)
         _touchPositionInfos[deviceIndex] = {};
     }
 
-    _isDispatchingInProgress = true;
-    for (i32 index = (i32)_listeners.size() - 1; index >= 0; --index)
+    uiw deviceBit = Funcs::IndexOfMostSignificantNonZeroBit(action.device.AsInteger());
+    uiw kindBit = Funcs::IndexOfMostSignificantNonZeroBit(ControlActionKindOf(action).AsInteger());
+    const auto &bucket = _listenersBuckets[deviceBit][kindBit];
+
+    // RemoveListener adjusts the frames' positions, so listeners may be removed while they're being called
+    // the frame is accessed by index, a nested dispatch may reallocate _dispatchFrames
+    uiw frameIndex = _dispatchFrames.size();
+    _dispatchFrames.push_back({&bucket, bucket.size()});
+    while (_dispatchFrames[frameIndex].position > 0)
     {
-        const auto &listener = _listeners[index];
-        if (listener.deviceMask.Contains(action.device))
+        uiw position = --_dispatchFrames[frameIndex].position;
+        if ((*bucket[position])(cookedAction))
         {
-            if (listener.listener(cookedAction))
-            {
-                break;
-            }
+            break;
         }
     }
-    _isDispatchingInProgress = false;
+    _dispatchFrames.pop_back();
 
-    if (_isListenersDirty)
+    // an outer dispatch may still be calling a removed listener
+    if (_dispatchFrames.empty())
     {
-        _listeners.erase(std::remove_if(_listeners.begin(), _listeners.end(), [](const MessageListener &listener) { return listener.deviceMask == DeviceTypes::_None; }));
-        _isListenersDirty = false;
+        _listenersRemovedWhileDispatching.clear();
     }
 }
 
-void KeyController::Dispatch(std::experimental::generator<ControlAction> enumerable)
+void KeyController::Dispatch(span<const ControlAction> actions)
 {
-    for (const auto &action : enumerable)
+    for (const auto &action : actions)
     {
         Dispatch(action);
     }
@@ -128,16 +126,24 @@ void KeyController::Dispatch(std::experimental::generator<ControlAction> enumera
 void KeyController::Update()
 {}
 
-auto KeyController::OnControlAction(const ListenerCallbackType &callback, DeviceTypes::DeviceType deviceMask) -> ListenerHandle
+auto KeyController::OnControlAction(const ListenerCallbackType &callback, DeviceTypes::DeviceType deviceMask, ControlActionKinds::ControlActionKind kindMask) -> ListenerHandle
 {
-    if (deviceMask == DeviceTypes::_None) // not an error, but probably not what you wanted either
+    if (deviceMask == DeviceTypes::_None || kindMask == ControlActionKinds::_None) // not an error, but probably not what you wanted either
     {
         SOFTBREAK;
         return {};
     }
 
     ui32 id = AssignId<MessageListener, ui32, &MessageListener::id>(_currentId, _listeners.begin(), _listeners.end());
-    _listeners.push_back({callback, deviceMask, id});
+    _listeners.push_back({make_unique<ListenerCallbackType>(callback), deviceMask, kindMask, id});
+
+    // new listeners are appended, so they won't be called by the dispatch that's currently in progress
+    ListenerCallbackType *listener = _listeners.back().listener.get();
+    ForEachListenerBucket(_listeners.back(), [listener](ListenersBucket &bucket)
+    {
+        bucket.push_back(listener);
+    });
+
     return {shared_from_this(), id};
 }
 
@@ -161,14 +167,43 @@ void KeyController::RemoveListener(ListenerHandle &handle)
         }
     }
 
-    if (_isDispatchingInProgress)
+    ListenerCallbackType *listener = _listeners[index].listener.get();
+    ForEachListenerBucket(_listeners[index], [this, listener](ListenersBucket &bucket)
     {
-        _listeners[index].deviceMask = DeviceTypes::_None;
-        _isListenersDirty = true;
+        uiw position = std::find(bucket.begin(), bucket.end(), listener) - bucket.begin();
+        ASSUME(position < bucket.size());
+        bucket.erase(bucket.begin() + position);
+        for (auto &frame : _dispatchFrames)
+        {
+            if (frame.bucket == &bucket && position < frame.position)
+            {
+                --frame.position;
+            }
+        }
+    });
+
+    if (!_dispatchFrames.empty())
+    {
+        _listenersRemovedWhileDispatching.push_back(move(_listeners[index].listener));
     }
-    else
+    _listeners.erase(_listeners.begin() + index);
+}
+
+template <typename Function> void KeyController::ForEachListenerBucket(const MessageListener &listener, Function &&function)
+{
+    for (uiw deviceBit = 0; deviceBit < DeviceBitsCount; ++deviceBit)
     {
-        _listeners.erase(_listeners.begin() + index);
+        if (!Funcs::IsBitSet(listener.deviceMask.AsInteger(), deviceBit))
+        {
+            continue;
+        }
+        for (uiw kindBit = 0; kindBit < ActionKindsCount; ++kindBit)
+        {
+            if (Funcs::IsBitSet(listener.kindMask.AsInteger(), kindBit))
+            {
+                function(_listenersBuckets[deviceBit][kindBit]);
+            }
+        }
     }
 }
 
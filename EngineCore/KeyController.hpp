@@ -18,25 +18,44 @@ namespace EngineCore
 
         virtual ~KeyController() override = default;
 		virtual void Dispatch(const ControlAction &action) override;
-		virtual void Dispatch(std::experimental::generator<ControlAction> enumerable) override;
+		virtual void Dispatch(span<const ControlAction> actions) override;
         virtual void Update() override;
         [[nodiscard]] virtual KeyInfo GetKeyInfo(KeyCode key, DeviceTypes::DeviceType device = DeviceTypes::MouseKeyboard) const override;
         [[nodiscard]] virtual optional<i32Vector2> GetPositionInfo(DeviceTypes::DeviceType device = DeviceTypes::MouseKeyboard) const override;
         [[nodiscard]] virtual const AllKeyStates &GetAllKeyStates(DeviceTypes::DeviceType device = DeviceTypes::MouseKeyboard) const override;
-        [[nodiscard]] virtual ListenerHandle OnControlAction(const ListenerCallbackType &callback, DeviceTypes::DeviceType deviceMask) override;
+        [[nodiscard]] virtual ListenerHandle OnControlAction(const ListenerCallbackType &callback, DeviceTypes::DeviceType deviceMask, ControlActionKinds::ControlActionKind kindMask = ControlActionKinds::_All) override;
         virtual void RemoveListener(ListenerHandle &handle) override;
 
 	private:
         struct MessageListener
         {
-            ListenerCallbackType listener{};
+            unique_ptr<ListenerCallbackType> listener{}; // allocated separately, so the buckets' pointers survive _listeners reallocations
             DeviceTypes::DeviceType deviceMask{};
+            ControlActionKinds::ControlActionKind kindMask{};
             ui32 id{};
         };
 
+        // every listener is put into a bucket for each device bit and action kind it's subscribed to,
+        // a bucket keeps the registration order and is dispatched from the back, so the most recent listener goes first
+        using ListenersBucket = vector<ListenerCallbackType *>;
+        static constexpr uiw DeviceBitsCount = 19;
+        static constexpr uiw ActionKindsCount = 4;
+        static_assert(DeviceTypes::_AllDevices.AsInteger() == (1u << DeviceBitsCount) - 1, "DeviceBitsCount must cover all the device bits");
+        static_assert(ControlActionKinds::_All.AsInteger() == (1u << ActionKindsCount) - 1, "ActionKindsCount must cover all the action kinds");
+
+        // listeners may dispatch actions themselves, so there's a frame per nested Dispatch, the innermost is the last
+        struct DispatchFrame
+        {
+            const ListenersBucket *bucket = nullptr;
+            uiw position = 0; // index of the listener being called in bucket
+        };
+
+        template <typename Function> void ForEachListenerBucket(const MessageListener &listener, Function &&function);
+
         vector<MessageListener> _listeners{};
-        bool _isListenersDirty = false;
-        bool _isDispatchingInProgress = false;
+        array<array<ListenersBucket, ActionKindsCount>, DeviceBitsCount> _listenersBuckets{};
+        vector<unique_ptr<ListenerCallbackType>> _listenersRemovedWhileDispatching{}; // a listener may remove itself, so it's destroyed when the outermost dispatch ends
+        vector<DispatchFrame> _dispatchFrames{};
         ui32 _currentId = 0;
         array<AllKeyStates, 1> _mouseKeyboardKeyStates{};
         array<AllKeyStates, 8> _joystickKeyStates{};
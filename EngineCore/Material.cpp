@@ -32,6 +32,17 @@ shared_ptr<Material> Material::New(const shared_ptr<class Shader> &shader)
 	return make_shared<Proxy>(shader);
 }
 
+shared_ptr<Material> Material::New(const shared_ptr<class Shader> &shader, ShaderVariantKey variantKey)
+{
+	if (shader == nullptr)
+	{
+		SENDLOG(Error, "Cannot create material with nullptr shader\n");
+		return nullptr;
+	}
+
+	return New(Shader::Variant(shader, variantKey));
+}
+
 void Material::Name(string_view name)
 {
 	_name = name;
@@ -51,6 +62,11 @@ const shared_ptr<Shader> &Material::Shader() const
 	return _shader;
 }
 
+ShaderHandle Material::BoundShader() const
+{
+	return _shader;
+}
+
 auto Material::UniformNameToId(string_view name) const -> uid
 {
 	auto searchResult = std::find_if(_shader->Uniforms().begin(), _shader->Uniforms().end(), 
@@ -52,6 +52,7 @@ namespace EngineCore
 
 	public:
 		static shared_ptr<Material> New(const shared_ptr<class Shader> &shader);
+		static shared_ptr<Material> New(const shared_ptr<class Shader> &shader, ShaderVariantKey variantKey); // binds to the shader's variant, see Shader::Variant
 
 		void Name(string_view name);
 		string_view Name() const;
@@ -66,6 +67,7 @@ namespace EngineCore
 		};
 
 		const shared_ptr<Shader> &Shader() const;
+		ShaderHandle BoundShader() const; // the material keeps its shader alive, the draw path uses the handle instead of the owning pointer
 
 		uid UniformNameToId(string_view name) const;
 
@@ -0,0 +1,390 @@
+#include "BasicHeader.hpp"
+#include "NullRenderer.hpp"
+#include "RendererArray.hpp"
+#include "RendererPipelineState.hpp"
+#include "Material.hpp"
+#include "Shader.hpp"
+#include "Application.hpp"
+#include "Logger.hpp"
+#include <unordered_set>
+
+using namespace EngineCore;
+
+namespace
+{
+    struct BackendData
+    {
+        void **backendDataPointer{};
+        const RendererArray *array{}; // nullptr if the frontend isn't an array
+
+        virtual ~BackendData() = default;
+    };
+
+    // the arrays' contents are kept to serve locks
+    struct ArrayBackendData : BackendData
+    {
+        BufferOwnedData data{};
+    };
+}
+
+class NullRendererImpl final : public NullRenderer
+{
+    std::unordered_set<BackendData *> _allocatedBackendDatas{};
+    NullRendererCounters _counters{};
+    RendererFrameStats _lastFrameStats{};
+    array<shared_ptr<const RendererVertexArray>, 8> _boundVertexArrays{};
+    shared_ptr<const RendererIndexArray> _boundIndexArray{};
+    RendererCommandBuffer _recordedCommands{};
+    const Camera *_recordedCamera = nullptr;
+    const RendererPipelineState *_recordedPipelineState = nullptr;
+    const Material *_recordedMaterial = nullptr;
+    bool _isRecordingCommands = false;
+
+    template <typename T> T &AcquireBackendData(const RendererFrontendData &frontendData)
+    {
+        auto *data = RendererBackendData<BackendData>(frontendData);
+        if (data == nullptr)
+        {
+            data = new T;
+            data->backendDataPointer = RendererBackendDataPointer(frontendData);
+            RendererBackendData(frontendData, data);
+            _allocatedBackendDatas.insert(data);
+            ++_counters.backendDataAllocations;
+        }
+        return *static_cast<T *>(data);
+    }
+
+    ArrayBackendData &AcquireArrayBackendData(const RendererArray &array)
+    {
+        auto &arrayData = AcquireBackendData<ArrayBackendData>(array);
+        arrayData.array = &array;
+        return arrayData;
+    }
+
+    // the part of a real backend's Check*BackendData that doesn't depend on the API
+    void CheckBackendData(const RendererFrontendData &frontendData)
+    {
+        if (RendererBackendData(frontendData) == nullptr)
+        {
+            AcquireBackendData<BackendData>(frontendData);
+        }
+        else if (RendererFrontendDataDirtyState(frontendData))
+        {
+            ++_counters.backendDataUpdates;
+        }
+        RendererFrontendDataDirtyState(frontendData, false);
+    }
+
+    void CheckDrawBackendDatas(const RendererPipelineState *pipelineState, const Material *material)
+    {
+        if (pipelineState != nullptr)
+        {
+            CheckBackendData(*pipelineState);
+        }
+        if (material != nullptr)
+        {
+            if (auto shader = material->BoundShader())
+            {
+                CheckBackendData(*shader);
+            }
+            CheckBackendData(*material);
+        }
+    }
+
+    // returns false if the draw shouldn't be recorded
+    bool RecordDrawState(const Camera *camera, const RendererPipelineState *pipelineState, const Material *material)
+    {
+        if (_isRecordingCommands == false)
+        {
+            return false;
+        }
+        if (camera != _recordedCamera)
+        {
+            _recordedCamera = camera;
+            _recordedCommands.SetCamera(camera);
+        }
+        if (pipelineState != _recordedPipelineState)
+        {
+            _recordedPipelineState = pipelineState;
+            _recordedCommands.SetPipelineState(pipelineState);
+        }
+        if (material != _recordedMaterial)
+        {
+            _recordedMaterial = material;
+            _recordedCommands.SetMaterial(material);
+        }
+        return true;
+    }
+
+    void CountUpload(ui32 sizeInBytes)
+    {
+        ++_counters.arrayUploads;
+        _counters.uploadedBytes += sizeInBytes;
+    }
+
+public:
+    virtual ~NullRendererImpl() override
+    {
+        for (auto &data : _allocatedBackendDatas)
+        {
+            *data->backendDataPointer = nullptr;
+            delete data;
+        }
+    }
+
+    virtual bool CreateArrayRegion(const RendererArray &array, BufferOwnedData data) override
+    {
+        auto &arrayData = AcquireArrayBackendData(array);
+        RendererFrontendDataDirtyState(array, false);
+        arrayData.data = DetachTransientData(move(data), array.NumberOfElements() * array.Stride());
+        CountUpload(array.NumberOfElements() * array.Stride());
+        return true;
+    }
+
+    virtual void UpdateArrayRegion(const RendererArray &array, BufferOwnedData data, ui32 sizeInBytes, ui32 offsetInBytes) override
+    {
+        if (data == nullptr)
+        {
+            SOFTBREAK;
+            return;
+        }
+
+        auto &arrayData = AcquireArrayBackendData(array);
+        ui32 arrayTotalSize = array.NumberOfElements() * array.Stride();
+        if (sizeInBytes == arrayTotalSize)
+        {
+            arrayData.data = DetachTransientData(move(data), sizeInBytes);
+        }
+        else
+        {
+            if (arrayData.data == nullptr)
+            {
+                arrayData.data = BufferOwnedData{new ui8[arrayTotalSize], [](void *p) {delete[] p; }};
+            }
+            MemOps::Copy(arrayData.data.get() + offsetInBytes, data.get(), sizeInBytes);
+        }
+        CountUpload(sizeInBytes);
+    }
+
+    virtual ui8 *LockArrayRegionForWrite(const RendererArray &array, ui32 sizeInBytes, ui32 offsetInBytes) override
+    {
+        auto &arrayData = AcquireArrayBackendData(array);
+        if (arrayData.data == nullptr)
+        {
+            arrayData.data = BufferOwnedData{new ui8[array.NumberOfElements() * array.Stride()], [](void *p) {delete[] p; }};
+        }
+        return arrayData.data.get() + offsetInBytes;
+    }
+
+    virtual void UnlockArrayRegion(const RendererArray &array) override
+    {
+        auto *arrayData = RendererBackendData<ArrayBackendData>(array);
+        if (arrayData != nullptr)
+        {
+            // the frontend resets the locked region only after this call
+            CountUpload((array.LockedRegionEnd() - array.LockedRegionStart()) * array.Stride());
+        }
+    }
+
+    virtual bool CreateTextureRegion(const Texture &texture, BufferOwnedData data, TextureDataFormat dataFormat) override
+    {
+        CheckBackendData(texture);
+        return true;
+    }
+
+    virtual void NotifyFrontendDataIsBeingDeleted(const RendererFrontendData &frontendData) override
+    {
+        auto castedData = RendererBackendData<BackendData>(frontendData);
+        assert(castedData != nullptr); // there should be no notification for nullptr datas
+        size_t removed = _allocatedBackendDatas.erase(castedData);
+        assert(removed == 1);
+        delete castedData;
+        ++_counters.backendDataDeletions;
+    }
+
+    virtual void ClearCameraTargets(const Camera *camera) override
+    {
+        ++_counters.clears;
+        if (_isRecordingCommands)
+        {
+            if (camera != _recordedCamera)
+            {
+                _recordedCamera = camera;
+                _recordedCommands.SetCamera(camera);
+            }
+            _recordedCommands.ClearCameraTargets();
+        }
+    }
+
+    virtual bool BindVertexArray(const shared_ptr<const RendererVertexArray> &array, ui32 number) override
+    {
+        if (number >= _boundVertexArrays.size())
+        {
+            SENDLOG(Error, "BindVertexArray called with number %u, but current renderer supports maximum %u arrays\n", number, (ui32)_boundVertexArrays.size());
+            return false;
+        }
+
+        if (_boundVertexArrays[number] != array)
+        {
+            _boundVertexArrays[number] = array;
+            ++_counters.vertexArrayBinds;
+            if (_isRecordingCommands)
+            {
+                _recordedCommands.BindVertexArray(array, number);
+            }
+        }
+
+        return true;
+    }
+
+    virtual bool BindIndexArray(const shared_ptr<const RendererIndexArray> &array) override
+    {
+        if (_boundIndexArray != array)
+        {
+            _boundIndexArray = array;
+            ++_counters.indexArrayBinds;
+            if (_isRecordingCommands)
+            {
+                _recordedCommands.BindIndexArray(array);
+            }
+        }
+
+        return true;
+    }
+
+    virtual void DrawIntoRenderTarget(const RenderTarget *rt, const Vector3 *cameraPos, const Matrix4x3 *viewMatrix, const Matrix4x4 *projMatrix, const Matrix4x3 *modelMatrix, const RendererPipelineState *pipelineState, const Material *material, PrimitiveTopology topology, ui32 numVertices, ui32 instanceCount) override
+    {
+        CheckDrawBackendDatas(pipelineState, material);
+        ++_counters.draws;
+    }
+
+    virtual void DrawIndexedIntoRenderTarget(const RenderTarget *rt, const Vector3 *cameraPos, const Matrix4x3 *viewMatrix, const Matrix4x4 *projMatrix, const Matrix4x3 *modelMatrix, const RendererPipelineState *pipelineState, const Material *material, PrimitiveTopology topology, ui32 numIndexes, ui32 instanceCount) override
+    {
+        CheckDrawBackendDatas(pipelineState, material);
+        ++_counters.indexedDraws;
+    }
+
+    virtual void DrawWithCamera(const Camera *camera, const Matrix4x3 *modelMatrix, const RendererPipelineState *pipelineState, const Material *material, PrimitiveTopology topology, ui32 numVertices, ui32 instanceCount) override
+    {
+        CheckDrawBackendDatas(pipelineState, material);
+        ++_counters.draws;
+        if (RecordDrawState(camera, pipelineState, material))
+        {
+            _recordedCommands.Draw(modelMatrix, topology, numVertices, instanceCount);
+        }
+    }
+
+    virtual void DrawIndexedWithCamera(const Camera *camera, const Matrix4x3 *modelMatrix, const RendererPipelineState *pipelineState, const Material *material, PrimitiveTopology topology, ui32 numIndexes, ui32 instanceCount) override
+    {
+        CheckDrawBackendDatas(pipelineState, material);
+        ++_counters.indexedDraws;
+        if (RecordDrawState(camera, pipelineState, material))
+        {
+            _recordedCommands.DrawIndexed(modelMatrix, topology, numIndexes, instanceCount);
+        }
+    }
+
+    virtual void DrawIndexedIndirectWithCamera(const Camera *camera, const Matrix4x3 *modelMatrix, const RendererPipelineState *pipelineState, const Material *material, PrimitiveTopology topology, span<const RendererIndirectDraw> draws) override
+    {
+        CheckDrawBackendDatas(pipelineState, material);
+        ++_counters.indirectDraws;
+        if (RecordDrawState(camera, pipelineState, material))
+        {
+            _recordedCommands.DrawIndexedIndirect(modelMatrix, topology, draws);
+        }
+    }
+
+    virtual void PrecompileShaders(span<const shared_ptr<Shader>> shaders, bool isBlocking) override
+    {
+        for (const auto &shader : shaders)
+        {
+            CheckBackendData(*shader);
+        }
+    }
+
+    virtual void BeginFrame() override
+    {
+        _counters = {};
+
+        _recordedCommands.Reset();
+        _recordedCamera = nullptr;
+        _recordedPipelineState = nullptr;
+        _recordedMaterial = nullptr;
+        if (_isRecordingCommands)
+        {
+            // the bindings persist between frames, so they're recorded to keep every frame's recording self-contained
+            for (ui32 number = 0; number < _boundVertexArrays.size(); ++number)
+            {
+                if (_boundVertexArrays[number] != nullptr)
+                {
+                    _recordedCommands.BindVertexArray(_boundVertexArrays[number], number);
+                }
+            }
+            if (_boundIndexArray != nullptr)
+            {
+                _recordedCommands.BindIndexArray(_boundIndexArray);
+            }
+        }
+    }
+
+    virtual void EndFrame() override
+    {
+        _lastFrameStats = {_counters.draws + _counters.indexedDraws + _counters.indirectDraws, 0, 0};
+        ResetTransientAllocator();
+    }
+
+    virtual RendererFrameStats LastFrameStats() const override
+    {
+        return _lastFrameStats;
+    }
+
+    virtual vector<RendererArrayMemory> ArraysMemory() const override
+    {
+        vector<RendererArrayMemory> result;
+        for (const auto *data : _allocatedBackendDatas)
+        {
+            if (data->array != nullptr)
+            {
+                RendererArrayMemory memory;
+                memory.name = data->array->Name();
+                memory.shadowBytes = static_cast<const ArrayBackendData *>(data)->data ? (ui64)data->array->NumberOfElements() * data->array->Stride() : 0;
+                result.push_back(memory);
+            }
+        }
+        return result;
+    }
+
+    virtual const NullRendererCounters &FrameCounters() const override
+    {
+        return _counters;
+    }
+
+    virtual bool IsRecordingCommands() const override
+    {
+        return _isRecordingCommands;
+    }
+
+    virtual void IsRecordingCommands(bool isRecording) override
+    {
+        _isRecordingCommands = isRecording;
+    }
+
+    virtual const RendererCommandBuffer &RecordedCommands() const override
+    {
+        return _recordedCommands;
+    }
+
+    virtual void SwapBuffers() override
+    {}
+
+    virtual void *RendererContext() override
+    {
+        return nullptr;
+    }
+};
+
+shared_ptr<NullRenderer> NullRenderer::New()
+{
+    SENDLOG(Info, "NullRenderer's created\n");
+    return make_shared<NullRendererImpl>();
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Renderer.hpp"
+#include "RendererCommandBuffer.hpp"
+
+namespace EngineCore
+{
+    // counted since the last BeginFrame, so after EndFrame they describe the whole frame
+    struct NullRendererCounters
+    {
+        ui32 draws = 0, indexedDraws = 0, indirectDraws = 0; // calls, an indirect call counts once
+        ui32 clears = 0;
+        ui32 vertexArrayBinds = 0, indexArrayBinds = 0; // only the ones that changed the binding
+        ui32 arrayUploads = 0; // creations, updates and unlocks
+        ui64 uploadedBytes = 0;
+        ui32 backendDataAllocations = 0;
+        ui32 backendDataUpdates = 0; // dirty materials, pipeline states and shaders that would've been re-uploaded by a real backend
+        ui32 backendDataDeletions = 0;
+    };
+
+    // a renderer that doesn't talk to any graphics API, used when the application runs without a window or GPU
+    // array locks still return valid memory, so the CPU side of uploading data is executed the same way
+    // backend datas are allocated, checked for the dirty state and deleted like a real backend does, so the frontend's bookkeeping is exercised too
+    class NullRenderer : public Renderer
+    {
+    protected:
+        NullRenderer() = default;
+
+    public:
+        static shared_ptr<NullRenderer> New();
+
+        [[nodiscard]] virtual const NullRendererCounters &FrameCounters() const = 0;
+
+        // draws with a camera are recorded as command buffer commands, state commands are recorded only when the state changes
+        // draws into a render target have no command representation and are only counted
+        // the recording is reset by BeginFrame
+        [[nodiscard]] virtual bool IsRecordingCommands() const = 0;
+        virtual void IsRecordingCommands(bool isRecording) = 0;
+        [[nodiscard]] virtual const RendererCommandBuffer &RecordedCommands() const = 0;
+    };
+}
\ No newline at end of file
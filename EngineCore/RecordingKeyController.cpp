@@ -1,6 +1,7 @@
 #include "BasicHeader.hpp"
 #include "RecordingKeyController.hpp"
 #include <AssignListenerId.hpp>
+#include "Logger.hpp"
 
 using namespace EngineCore;
 
@@ -9,6 +10,11 @@ RecordingKeyController::RecordingKeyController(const shared_ptr<IKeyController>
     ASSUME(nextController);
 }
 
+RecordingKeyController::~RecordingKeyController()
+{
+    StopRecording();
+}
+
 shared_ptr<RecordingKeyController> RecordingKeyController::New(const shared_ptr<IKeyController> &nextController)
 {
     struct Proxy : public RecordingKeyController
@@ -20,6 +26,7 @@ shared_ptr<RecordingKeyController> RecordingKeyController::New(const shared_ptr<
 
 void RecordingKeyController::Dispatch(const ControlAction &action)
 {
+    Record(action);
     for (i32 index = (i32)_recordingListenerHandles.size() - 1; index >= 0; --index)
     {
         _recordingListenerHandles[index].listener(action);
@@ -27,16 +34,23 @@ void RecordingKeyController::Dispatch(const ControlAction &action)
     return _nextController->Dispatch(action);
 }
 
-void RecordingKeyController::Dispatch(std::experimental::generator<ControlAction> enumerable)
+void RecordingKeyController::Dispatch(span<const ControlAction> actions)
 {
-    for (const auto &action : enumerable)
+    // recording listeners see every action right before the next controller does, as with a single action,
+    // so the batch is forwarded as a whole only when there're no listeners to interleave with
+    if (_recordingListenerHandles.empty())
     {
-        for (i32 index = (i32)_recordingListenerHandles.size() - 1; index >= 0; --index)
+        for (const auto &action : actions)
         {
-            _recordingListenerHandles[index].listener(action);
+            Record(action);
         }
+        _nextController->Dispatch(actions);
+        return;
+    }
 
-        _nextController->Dispatch(action);
+    for (const auto &action : actions)
+    {
+        Dispatch(action);
     }
 }
 
@@ -60,9 +74,9 @@ auto RecordingKeyController::GetAllKeyStates(DeviceTypes::DeviceType device) con
     return _nextController->GetAllKeyStates(device);
 }
 
-auto RecordingKeyController::OnControlAction(const ListenerCallbackType &callback, DeviceTypes::DeviceType deviceMask) -> ListenerHandle
+auto RecordingKeyController::OnControlAction(const ListenerCallbackType &callback, DeviceTypes::DeviceType deviceMask, ControlActionKinds::ControlActionKind kindMask) -> ListenerHandle
 {
-    return _nextController->OnControlAction(callback, deviceMask);
+    return _nextController->OnControlAction(callback, deviceMask, kindMask);
 }
 
 void RecordingKeyController::RemoveListener(ListenerHandle &handle)
@@ -99,3 +113,74 @@ auto RecordingKeyController::OnRecordingControlAction(const ListenerCallbackType
     _recordingListenerHandles.push_back({callback, id});
     return {shared_from_this(), id};
 }
+
+
+bool RecordingKeyController::StartRecording(const FilePath &path)
+{
+    StopRecording();
+
+    File file = File(path, FileOpenMode::CreateAlways, FileProcModes::Write);
+    if (!file.IsOpen())
+    {
+        SENDLOG(Error, "RecordingKeyController failed to create file " PTHSTR "\n", path.PlatformPath().data());
+        return false;
+    }
+
+    ControlActionsLog::Header header;
+    if (!file.Write(&header, sizeof(header)))
+    {
+        SENDLOG(Error, "RecordingKeyController failed to write the header into " PTHSTR "\n", path.PlatformPath().data());
+        return false;
+    }
+
+    _recordingFile = move(file);
+    _lastRecordedMoment = TimeMoment::Now();
+    _recordingBufferSize = 0;
+    return true;
+}
+
+void RecordingKeyController::StopRecording()
+{
+    if (!_recordingFile.IsOpen())
+    {
+        return;
+    }
+
+    FlushRecording();
+    _recordingFile = {};
+}
+
+bool RecordingKeyController::IsRecording() const
+{
+    return _recordingFile.IsOpen();
+}
+
+void RecordingKeyController::Record(const ControlAction &action)
+{
+    if (!_recordingFile.IsOpen())
+    {
+        return;
+    }
+
+    if (_recordingBuffer.size() - _recordingBufferSize < ControlActionsLog::MaxEncodedActionSize)
+    {
+        FlushRecording();
+    }
+
+    _recordingBufferSize += ControlActionsLog::Encode(action, _lastRecordedMoment, _recordingBuffer.data() + _recordingBufferSize);
+}
+
+void RecordingKeyController::FlushRecording()
+{
+    if (_recordingBufferSize == 0)
+    {
+        return;
+    }
+
+    if (!_recordingFile.Write(_recordingBuffer.data(), (ui32)_recordingBufferSize))
+    {
+        SENDLOG(Error, "RecordingKeyController failed to write recorded actions, recording is stopped\n");
+        _recordingFile = {};
+    }
+    _recordingBufferSize = 0;
+}
\ No newline at end of file
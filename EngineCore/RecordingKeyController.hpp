@@ -1,6 +1,7 @@
 #pragma once
 
 #include "IKeyController.hpp"
+#include "ControlActionsLog.hpp"
 
 namespace EngineCore
 {
@@ -14,16 +15,20 @@ namespace EngineCore
     public:
         static shared_ptr<RecordingKeyController> New(const shared_ptr<IKeyController> &nextController);
 
-        virtual ~RecordingKeyController() = default;
+        virtual ~RecordingKeyController() override;
         virtual void Dispatch(const ControlAction &action) override;
-        virtual void Dispatch(std::experimental::generator<ControlAction> enumerable) override;
+        virtual void Dispatch(span<const ControlAction> actions) override;
         virtual void Update() override;
         [[nodiscard]] virtual KeyInfo GetKeyInfo(KeyCode key, DeviceTypes::DeviceType device = DeviceTypes::MouseKeyboard) const override;
         [[nodiscard]] virtual optional<i32Vector2> GetPositionInfo(DeviceTypes::DeviceType device = DeviceTypes::MouseKeyboard) const override;
         [[nodiscard]] virtual const AllKeyStates &GetAllKeyStates(DeviceTypes::DeviceType device = DeviceTypes::MouseKeyboard) const override;
-        [[nodiscard]] virtual ListenerHandle OnControlAction(const ListenerCallbackType &callback, DeviceTypes::DeviceType deviceMask) override;
+        [[nodiscard]] virtual ListenerHandle OnControlAction(const ListenerCallbackType &callback, DeviceTypes::DeviceType deviceMask, ControlActionKinds::ControlActionKind kindMask = ControlActionKinds::_All) override;
         virtual void RemoveListener(ListenerHandle &handle) override;
         [[nodiscard]] ListenerHandle OnRecordingControlAction(const ListenerCallbackType &callback); // you can use RemoveListener to detach
+        // streams all subsequent actions into the file using the ControlActionsLog format, replaces the current recording if there is one
+        [[nodiscard]] bool StartRecording(const FilePath &path);
+        void StopRecording();
+        [[nodiscard]] bool IsRecording() const;
 
     private:        
         struct MessageListener
@@ -31,8 +36,15 @@ namespace EngineCore
             ListenerCallbackType listener{};
             ui32 id{};
         };
+        void Record(const ControlAction &action);
+        void FlushRecording();
+
         shared_ptr<IKeyController> _nextController{};
         ui32 _currentId = 0;
         vector<MessageListener> _recordingListenerHandles{};
+        File _recordingFile{};
+        TimeMoment _lastRecordedMoment{};
+        array<ui8, 4096> _recordingBuffer; // encoded actions are accumulated here to avoid a write per action
+        uiw _recordingBufferSize = 0;
     };
 }
\ No newline at end of file
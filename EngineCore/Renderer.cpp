@@ -1,6 +1,8 @@
 #include "BasicHeader.hpp"
 #include "Renderer.hpp"
+#include "RendererCommandBuffer.hpp"
 #include "Application.hpp"
+#include "Logger.hpp"
 
 using namespace EngineCore;
 
@@ -29,6 +31,104 @@ void Renderer::RendererFrontendDataDirtyState(const RendererFrontendData &fronte
     frontendData._is_updatedByFrontEnd = isChanged;
 }
 
+void Renderer::SubmitCommandBuffers(span<const RendererCommandBuffer *const> buffers)
+{
+    using CommandType = RendererCommandBuffer::CommandType;
+
+    for (const RendererCommandBuffer *buffer : buffers)
+    {
+        const Camera *camera = nullptr;
+        const RendererPipelineState *pipelineState = nullptr;
+        const Material *material = nullptr;
+
+        for (const auto &command : buffer->Commands())
+        {
+            const Matrix4x3 *modelMatrix = nullptr;
+
+            switch (command.type)
+            {
+            case CommandType::SetCamera:
+                camera = (const Camera *)command.object;
+                break;
+            case CommandType::ClearCameraTargets:
+                ClearCameraTargets(camera);
+                break;
+            case CommandType::BindVertexArray:
+                BindVertexArray(command.index == RendererCommandBuffer::NoIndex ? nullptr : buffer->VertexArrays()[command.index], command.arrayNumber);
+                break;
+            case CommandType::BindIndexArray:
+                BindIndexArray(command.index == RendererCommandBuffer::NoIndex ? nullptr : buffer->IndexArrays()[command.index]);
+                break;
+            case CommandType::SetPipelineState:
+                pipelineState = (const RendererPipelineState *)command.object;
+                break;
+            case CommandType::SetMaterial:
+                material = (const Material *)command.object;
+                break;
+            case CommandType::Draw:
+            case CommandType::DrawIndexed:
+            case CommandType::DrawIndexedIndirect:
+                if (command.index != RendererCommandBuffer::NoIndex)
+                {
+                    modelMatrix = &buffer->ModelMatrices()[command.index];
+                }
+                if (command.type == CommandType::Draw)
+                {
+                    DrawWithCamera(camera, modelMatrix, pipelineState, material, command.topology, command.count, command.instanceCount);
+                }
+                else if (command.type == CommandType::DrawIndexed)
+                {
+                    DrawIndexedWithCamera(camera, modelMatrix, pipelineState, material, command.topology, command.count, command.instanceCount);
+                }
+                else
+                {
+                    DrawIndexedIndirectWithCamera(camera, modelMatrix, pipelineState, material, command.topology, buffer->IndirectDraws().subspan(command.firstIndirectDraw, command.count));
+                }
+                break;
+            }
+        }
+    }
+}
+
+BufferOwnedData Renderer::DetachTransientData(BufferOwnedData data, ui32 sizeInBytes) const
+{
+    if (data == nullptr || _transientAllocator.IsOwned(data.get()) == false)
+    {
+        return data;
+    }
+
+    BufferOwnedData copy{new ui8[sizeInBytes], [](void *p) {delete[] p; }};
+    MemOps::Copy(copy.get(), data.get(), sizeInBytes);
+    return copy;
+}
+
+void Renderer::ResetTransientAllocator()
+{
+    _transientAllocator.Reset();
+}
+
+FrameAllocator &Renderer::TransientAllocator()
+{
+    return _transientAllocator;
+}
+
+void Renderer::ReportArraysMemory() const
+{
+    auto arrays = ArraysMemory();
+    auto total = [](const RendererArrayMemory &memory) { return memory.gpuBytes + memory.shadowBytes + memory.stagingBytes; };
+    std::sort(arrays.begin(), arrays.end(), [&total](const RendererArrayMemory &left, const RendererArrayMemory &right) { return total(left) > total(right); });
+
+    RendererArrayMemory totals;
+    for (const auto &memory : arrays)
+    {
+        SENDLOG(Info, "Array %*s: GPU %u bytes, shadow %u bytes, staging %u bytes\n", SVIEWARG(memory.name), (ui32)memory.gpuBytes, (ui32)memory.shadowBytes, (ui32)memory.stagingBytes);
+        totals.gpuBytes += memory.gpuBytes;
+        totals.shadowBytes += memory.shadowBytes;
+        totals.stagingBytes += memory.stagingBytes;
+    }
+    SENDLOG(Info, "%u arrays: GPU %u KB, shadow %u KB, staging %u KB\n", (ui32)arrays.size(), (ui32)(totals.gpuBytes / 1024), (ui32)(totals.shadowBytes / 1024), (ui32)(totals.stagingBytes / 1024));
+}
+
 RendererFrontendData::~SystemFrontendData()
 {
     if (_backendData != nullptr)
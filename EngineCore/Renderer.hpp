@@ -2,10 +2,11 @@
 
 #include "System.hpp"
 #include "RendererDataResource.hpp"
+#include "FrameAllocator.hpp"
 
 namespace EngineCore
 {
-	enum class PrimitiveTopology
+	enum class PrimitiveTopology : ui8
 	{
 		Point,
 		TriangleEnumeration,
@@ -23,12 +24,41 @@ namespace EngineCore
     class RendererCommandBuffer;
     class Camera;
 
+    // the layout matches glMultiDrawElementsIndirect's DrawElementsIndirectCommand
+    struct RendererIndirectDraw
+    {
+        ui32 numIndexes = 0;
+        ui32 instanceCount = 1;
+        ui32 firstIndex = 0;
+        i32 baseVertex = 0;
+        ui32 baseInstance = 0; // offsets instanced vertex arrays, the portable way to give every draw its own data
+    };
+
+    // counted between BeginFrame and EndFrame, renderers that don't track something report 0 for it
+    struct RendererFrameStats
+    {
+        ui32 drawCalls = 0;
+        ui32 stateCalls = 0; // graphics API calls that changed the pipeline state
+        ui32 skippedStateCalls = 0; // state changes that weren't issued because the state had already been set
+    };
+
+    // memory a renderer holds for a RendererArray
+    struct RendererArrayMemory
+    {
+        string_view name{};
+        ui64 gpuBytes = 0;
+        ui64 shadowBytes = 0; // the CPU copy, kept only for readable arrays
+        ui64 stagingBytes = 0; // transient memory of an active lock
+    };
+
 	class Renderer
 	{
     private:
 		Renderer(Renderer &&) = delete;
 		Renderer &operator = (Renderer &&) = delete;
 
+        FrameAllocator _transientAllocator{};
+
 	protected:
         friend class RendererArray;
         friend class RendererVertexArray;
@@ -56,6 +86,11 @@ namespace EngineCore
 
         virtual bool CreateTextureRegion(const Texture &texture, BufferOwnedData data, TextureDataFormat dataFormat) = 0;
 
+        // data passed to the renderer may come from TransientAllocator, backends that keep it past the call must keep what this returns
+        // returns data itself if it's already owned, otherwise a heap copy of its first sizeInBytes bytes
+        BufferOwnedData DetachTransientData(BufferOwnedData data, ui32 sizeInBytes) const;
+        void ResetTransientAllocator(); // every backend's EndFrame must call it
+
 	public:
 		virtual ~Renderer() = default;
 
@@ -73,8 +108,26 @@ namespace EngineCore
         virtual void DrawWithCamera(const Camera *camera, const Matrix4x3 *modelMatrix, const RendererPipelineState *pipelineState, const Material *material, PrimitiveTopology topology, ui32 numVertices, ui32 instanceCount = 1) = 0;
         virtual void DrawIndexedWithCamera(const Camera *camera, const Matrix4x3 *modelMatrix, const RendererPipelineState *pipelineState, const Material *material, PrimitiveTopology topology, ui32 numIndexes, ui32 instanceCount = 1) = 0;
 
+        // many indexed draws that share the state and the bound arrays, submitted as a single API call where it's supported
+        // shaders can tell the draws apart with gl_DrawID or with instanced attributes offset by baseInstance
+        virtual void DrawIndexedIndirectWithCamera(const Camera *camera, const Matrix4x3 *modelMatrix, const RendererPipelineState *pipelineState, const Material *material, PrimitiveTopology topology, span<const RendererIndirectDraw> draws) = 0;
+
+        // executes the buffers in order, must be called from the render thread
+        // the default implementation replays the commands through the immediate functions above
+        virtual void SubmitCommandBuffers(span<const RendererCommandBuffer *const> buffers);
+
+        // starts compiling the shaders in the background, draws that use shaders which aren't ready yet are skipped
+        // pass isBlocking to wait until all queued shaders are compiled, e.g. during loading
+        virtual void PrecompileShaders(span<const shared_ptr<Shader>> shaders, bool isBlocking = false) = 0;
+
+        // per-frame memory for data passed to the renderer, e.g. RendererArray::UpdateDataRegion's source, it's reset by EndFrame
+        FrameAllocator &TransientAllocator();
+
 		virtual void BeginFrame() = 0;
 		virtual void EndFrame() = 0;
+        virtual RendererFrameStats LastFrameStats() const = 0; // stats of the last frame that has ended
+        virtual vector<RendererArrayMemory> ArraysMemory() const = 0; // one entry per array that has been created with this renderer
+        void ReportArraysMemory() const; // logs ArraysMemory sorted by the total size, and the totals
 		virtual void SwapBuffers() = 0;
 
         virtual void *RendererContext() = 0;
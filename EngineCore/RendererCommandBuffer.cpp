@@ -0,0 +1,133 @@
+#include "BasicHeader.hpp"
+#include "RendererCommandBuffer.hpp"
+
+using namespace EngineCore;
+
+void RendererCommandBuffer::Reset()
+{
+    _commands.clear();
+    _modelMatrices.clear();
+    _vertexArrays.clear();
+    _indexArrays.clear();
+    _indirectDraws.clear();
+}
+
+void RendererCommandBuffer::SetCamera(const Camera *camera)
+{
+    Command command;
+    command.type = CommandType::SetCamera;
+    command.object = camera;
+    _commands.push_back(command);
+}
+
+void RendererCommandBuffer::ClearCameraTargets()
+{
+    Command command;
+    command.type = CommandType::ClearCameraTargets;
+    _commands.push_back(command);
+}
+
+void RendererCommandBuffer::BindVertexArray(const shared_ptr<const RendererVertexArray> &array, ui32 number)
+{
+    ASSUME(number <= ui8_max);
+
+    Command command;
+    command.type = CommandType::BindVertexArray;
+    command.arrayNumber = (ui8)number;
+    if (array != nullptr)
+    {
+        command.index = (ui32)_vertexArrays.size();
+        _vertexArrays.push_back(array);
+    }
+    _commands.push_back(command);
+}
+
+void RendererCommandBuffer::BindIndexArray(const shared_ptr<const RendererIndexArray> &array)
+{
+    Command command;
+    command.type = CommandType::BindIndexArray;
+    if (array != nullptr)
+    {
+        command.index = (ui32)_indexArrays.size();
+        _indexArrays.push_back(array);
+    }
+    _commands.push_back(command);
+}
+
+void RendererCommandBuffer::SetPipelineState(const RendererPipelineState *pipelineState)
+{
+    Command command;
+    command.type = CommandType::SetPipelineState;
+    command.object = pipelineState;
+    _commands.push_back(command);
+}
+
+void RendererCommandBuffer::SetMaterial(const Material *material)
+{
+    Command command;
+    command.type = CommandType::SetMaterial;
+    command.object = material;
+    _commands.push_back(command);
+}
+
+void RendererCommandBuffer::Draw(const Matrix4x3 *modelMatrix, PrimitiveTopology topology, ui32 numVertices, ui32 instanceCount)
+{
+    AddDraw(CommandType::Draw, modelMatrix, topology, numVertices, instanceCount);
+}
+
+void RendererCommandBuffer::DrawIndexed(const Matrix4x3 *modelMatrix, PrimitiveTopology topology, ui32 numIndexes, ui32 instanceCount)
+{
+    AddDraw(CommandType::DrawIndexed, modelMatrix, topology, numIndexes, instanceCount);
+}
+
+void RendererCommandBuffer::DrawIndexedIndirect(const Matrix4x3 *modelMatrix, PrimitiveTopology topology, span<const RendererIndirectDraw> draws)
+{
+    AddDraw(CommandType::DrawIndexedIndirect, modelMatrix, topology, (ui32)draws.size(), 0);
+    _commands.back().firstIndirectDraw = (ui32)_indirectDraws.size();
+    _indirectDraws.insert(_indirectDraws.end(), draws.begin(), draws.end());
+}
+
+auto RendererCommandBuffer::Commands() const -> span<const Command>
+{
+    return _commands;
+}
+
+span<const Matrix4x3> RendererCommandBuffer::ModelMatrices() const
+{
+    return _modelMatrices;
+}
+
+span<const shared_ptr<const RendererVertexArray>> RendererCommandBuffer::VertexArrays() const
+{
+    return _vertexArrays;
+}
+
+span<const shared_ptr<const RendererIndexArray>> RendererCommandBuffer::IndexArrays() const
+{
+    return _indexArrays;
+}
+
+span<const RendererIndirectDraw> RendererCommandBuffer::IndirectDraws() const
+{
+    return _indirectDraws;
+}
+
+bool RendererCommandBuffer::IsEmpty() const
+{
+    return _commands.empty();
+}
+
+void RendererCommandBuffer::AddDraw(CommandType type, const Matrix4x3 *modelMatrix, PrimitiveTopology topology, ui32 count, ui32 instanceCount)
+{
+    Command command;
+    command.type = type;
+    command.topology = topology;
+    command.count = count;
+    command.instanceCount = instanceCount;
+    if (modelMatrix != nullptr)
+    {
+        command.index = (ui32)_modelMatrices.size();
+        _modelMatrices.push_back(*modelMatrix); // copied, so the matrix can be a temporary
+    }
+    _commands.push_back(command);
+}
\ No newline at end of file
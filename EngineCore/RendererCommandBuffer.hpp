@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Renderer.hpp"
+#include "MatrixMathTypes.hpp"
+
+namespace EngineCore
+{
+    // a list of draw commands recorded without touching the renderer and submitted with Renderer::SubmitCommandBuffers
+    // recording isn't synchronized, but separate buffers can be recorded from separate threads in parallel as long as the frontend objects they use aren't modified meanwhile
+    // vertex and index arrays are kept alive by the buffer, cameras, pipeline states and materials must outlive the submission
+    // camera, pipeline state and material are reset at the beginning of every buffer, array bindings aren't
+    class RendererCommandBuffer
+    {
+    public:
+        static constexpr ui32 NoIndex = ui32_max;
+
+        enum class CommandType : ui8
+        {
+            SetCamera, // object is a Camera
+            ClearCameraTargets,
+            BindVertexArray, // index is in VertexArrays() or NoIndex to unbind, arrayNumber is the binding number
+            BindIndexArray, // index is in IndexArrays() or NoIndex to unbind
+            SetPipelineState, // object is a RendererPipelineState
+            SetMaterial, // object is a Material
+            Draw, // index is in ModelMatrices() or NoIndex
+            DrawIndexed, // index is in ModelMatrices() or NoIndex
+            DrawIndexedIndirect // index is in ModelMatrices() or NoIndex, count is the number of draws
+        };
+
+        struct Command
+        {
+            CommandType type{};
+            ui8 arrayNumber = 0;
+            PrimitiveTopology topology{};
+            ui32 index = NoIndex;
+            ui32 count = 0; // vertices, indexes or indirect draws
+            ui32 instanceCount = 0; // 0 for DrawIndexedIndirect, the draws have their own
+            ui32 firstIndirectDraw = 0; // in IndirectDraws(), DrawIndexedIndirect only
+            const void *object = nullptr;
+        };
+
+    private:
+        vector<Command> _commands{};
+        vector<Matrix4x3> _modelMatrices{};
+        vector<shared_ptr<const RendererVertexArray>> _vertexArrays{};
+        vector<shared_ptr<const RendererIndexArray>> _indexArrays{};
+        vector<RendererIndirectDraw> _indirectDraws{};
+
+    public:
+        void Reset(); // removes all commands, the memory is kept for the next recording
+
+        void SetCamera(const Camera *camera);
+        void ClearCameraTargets();
+        void BindVertexArray(const shared_ptr<const RendererVertexArray> &array, ui32 number);
+        void BindIndexArray(const shared_ptr<const RendererIndexArray> &array);
+        void SetPipelineState(const RendererPipelineState *pipelineState);
+        void SetMaterial(const Material *material);
+        void Draw(const Matrix4x3 *modelMatrix, PrimitiveTopology topology, ui32 numVertices, ui32 instanceCount = 1);
+        void DrawIndexed(const Matrix4x3 *modelMatrix, PrimitiveTopology topology, ui32 numIndexes, ui32 instanceCount = 1);
+        void DrawIndexedIndirect(const Matrix4x3 *modelMatrix, PrimitiveTopology topology, span<const RendererIndirectDraw> draws);
+
+        [[nodiscard]] span<const Command> Commands() const;
+        [[nodiscard]] span<const Matrix4x3> ModelMatrices() const;
+        [[nodiscard]] span<const shared_ptr<const RendererVertexArray>> VertexArrays() const;
+        [[nodiscard]] span<const shared_ptr<const RendererIndexArray>> IndexArrays() const;
+        [[nodiscard]] span<const RendererIndirectDraw> IndirectDraws() const;
+        [[nodiscard]] bool IsEmpty() const;
+
+    private:
+        void AddDraw(CommandType type, const Matrix4x3 *modelMatrix, PrimitiveTopology topology, ui32 count, ui32 instanceCount);
+    };
+}
\ No newline at end of file
@@ -57,6 +57,7 @@ namespace EngineCore
 
         using BufferOwnedData = unique_ptr<ui8[], function<void(void *)>>;
 
+        // a write to a FrequentFull resource replaces its contents, the part outside of the written region becomes undefined
         struct CPUAccessMode
         {
             enum class Mode { NotAllowed, RareFull, RarePartial, FrequentFull, FrequentPartial };
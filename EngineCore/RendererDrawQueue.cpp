@@ -0,0 +1,212 @@
+#include "BasicHeader.hpp"
+#include "RendererDrawQueue.hpp"
+#include "Camera.hpp"
+#include "Material.hpp"
+
+using namespace EngineCore;
+
+void RendererDrawQueue::Clear()
+{
+    _draws.clear();
+    _entries.clear();
+    ++_generation;
+    _nextIds = {};
+    for (uiw category = 0; category < std::size(_ids); ++category)
+    {
+        // objects that are gone keep their entries, so they're dropped once there're many more than the ids the key can hold
+        if (_ids[category].size() > (4u << CategoryBits[category]))
+        {
+            _ids[category].clear();
+        }
+    }
+    _isSorted = true;
+}
+
+void RendererDrawQueue::Add(DrawDesc &&draw)
+{
+    ASSUME(draw.pipelineState != nullptr && draw.material != nullptr);
+
+    if (draw.layer >= LayersCount)
+    {
+        SOFTBREAK;
+        draw.layer = LayersCount - 1;
+    }
+
+    const void *renderTarget = draw.camera ? draw.camera->RenderTarget().get() : nullptr;
+    ui64 key = Key(draw.layer, IdOf(0, renderTarget), IdOf(1, draw.material->BoundShader().Get()), IdOf(2, draw.pipelineState), IdOf(3, draw.material), draw.depth);
+
+    _isSorted = _isSorted && (_entries.empty() || _entries.back().key <= key);
+    _entries.push_back({key, (ui32)_draws.size()});
+    _draws.push_back(move(draw));
+}
+
+void RendererDrawQueue::Sort()
+{
+    if (!_isSorted)
+    {
+        RadixSort(_entries, _scratch);
+        _isSorted = true;
+    }
+}
+
+ui32 RendererDrawQueue::WriteTo(RendererCommandBuffer &buffer) const
+{
+    const Camera *camera = nullptr;
+    const RendererPipelineState *pipelineState = nullptr;
+    const Material *material = nullptr;
+    array<const RendererVertexArray *, VertexArraysLimit> vertexArrays{};
+    const RendererIndexArray *indexArray = nullptr;
+    ui32 stateCommandsCount = 0;
+
+    for (const auto &entry : _entries)
+    {
+        const auto &draw = _draws[entry.index];
+
+        if (draw.camera != camera)
+        {
+            camera = draw.camera;
+            buffer.SetCamera(camera);
+            ++stateCommandsCount;
+        }
+        if (draw.pipelineState != pipelineState)
+        {
+            pipelineState = draw.pipelineState;
+            buffer.SetPipelineState(pipelineState);
+            ++stateCommandsCount;
+        }
+        if (draw.material != material)
+        {
+            material = draw.material;
+            buffer.SetMaterial(material);
+            ++stateCommandsCount;
+        }
+        // arrays the draw doesn't use are left bound, the pipeline's vertex layout decides what's read
+        for (ui32 number = 0; number < VertexArraysLimit; ++number)
+        {
+            if (draw.vertexArrays[number] != nullptr && draw.vertexArrays[number].get() != vertexArrays[number])
+            {
+                vertexArrays[number] = draw.vertexArrays[number].get();
+                buffer.BindVertexArray(draw.vertexArrays[number], number);
+                ++stateCommandsCount;
+            }
+        }
+        if (draw.indexArray != nullptr && draw.indexArray.get() != indexArray)
+        {
+            indexArray = draw.indexArray.get();
+            buffer.BindIndexArray(draw.indexArray);
+            ++stateCommandsCount;
+        }
+
+        const Matrix4x3 *modelMatrix = draw.modelMatrix ? &*draw.modelMatrix : nullptr;
+        if (draw.indexArray != nullptr)
+        {
+            buffer.DrawIndexed(modelMatrix, draw.topology, draw.count, draw.instanceCount);
+        }
+        else
+        {
+            buffer.Draw(modelMatrix, draw.topology, draw.count, draw.instanceCount);
+        }
+    }
+
+    return stateCommandsCount;
+}
+
+uiw RendererDrawQueue::Size() const
+{
+    return _draws.size();
+}
+
+auto RendererDrawQueue::Entries() const -> span<const SortEntry>
+{
+    return _entries;
+}
+
+ui64 RendererDrawQueue::Key(ui32 layer, ui32 renderTarget, ui32 shader, ui32 pipelineState, ui32 material, f32 depth)
+{
+    auto field = [](ui32 value, ui32 bits, ui32 shift)
+    {
+        ASSUME(value < (1u << bits));
+        return (ui64)value << shift;
+    };
+
+    ui32 depthBucket = (ui32)(std::clamp(depth, 0.0f, 1.0f) * (f32)((1u << DepthBits) - 1));
+
+    return field(layer, LayerBits, LayerShift) | field(renderTarget, RenderTargetBits, RenderTargetShift) | field(shader, ShaderBits, ShaderShift) |
+        field(pipelineState, PipelineStateBits, PipelineStateShift) | field(material, MaterialBits, MaterialShift) | field(depthBucket, DepthBits, DepthShift);
+}
+
+void RendererDrawQueue::RadixSort(span<SortEntry> entries, vector<SortEntry> &scratch)
+{
+    constexpr ui32 digitsCount = 8;
+
+    if (entries.size() < 2)
+    {
+        return;
+    }
+
+    // all the histograms are built in a single pass over the keys
+    array<array<ui32, 256>, digitsCount> histograms{};
+    for (const auto &entry : entries)
+    {
+        for (ui32 digit = 0; digit < digitsCount; ++digit)
+        {
+            ++histograms[digit][(entry.key >> (digit * 8)) & 0xFF];
+        }
+    }
+
+    scratch.resize(entries.size());
+    SortEntry *source = entries.data();
+    SortEntry *target = scratch.data();
+
+    for (ui32 digit = 0; digit < digitsCount; ++digit)
+    {
+        auto &histogram = histograms[digit];
+        if (histogram[(source[0].key >> (digit * 8)) & 0xFF] == entries.size())
+        {
+            continue;
+        }
+
+        ui32 offset = 0;
+        for (auto &count : histogram)
+        {
+            ui32 bucketSize = count;
+            count = offset;
+            offset += bucketSize;
+        }
+
+        for (uiw index = 0; index < entries.size(); ++index)
+        {
+            const auto &entry = source[index];
+            target[histogram[(entry.key >> (digit * 8)) & 0xFF]++] = entry;
+        }
+
+        std::swap(source, target);
+    }
+
+    if (source != entries.data())
+    {
+        MemOps::Copy(entries.data(), source, entries.size());
+    }
+}
+
+ui32 RendererDrawQueue::CountStateChanges(span<const SortEntry> entries)
+{
+    ui32 changes = 0;
+    for (uiw index = 1; index < entries.size(); ++index)
+    {
+        changes += (entries[index].key & StateMask) != (entries[index - 1].key & StateMask);
+    }
+    return changes;
+}
+
+ui32 RendererDrawQueue::IdOf(uiw category, const void *object)
+{
+    auto [it, isInserted] = _ids[category].try_emplace(object, Id{0, _generation - 1});
+    Id &id = it->second;
+    if (id.generation != _generation)
+    {
+        id.id = std::min(_nextIds[category]++, (1u << CategoryBits[category]) - 1);
+        id.generation = _generation;
+    }
+    return id.id;
+}
\ No newline at end of file
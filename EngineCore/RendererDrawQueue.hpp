@@ -0,0 +1,80 @@
+#pragma once
+
+#include "RendererCommandBuffer.hpp"
+#include <unordered_map>
+
+namespace EngineCore
+{
+    // collects self-contained draws, sorts them by a 64-bit key to minimize state changes and writes them into a command buffer
+    // the key is, from the most significant bits, layer, render target, shader, pipeline state, material and depth bucket
+    // ids in the key are assigned in the order objects are first seen since the last Clear, objects past a field's limit share its last id,
+    // which only makes the ordering less optimal, every draw carries its full state
+    // layer is the only way to force an order between draws, e.g. an opaque layer before a transparent one
+    class RendererDrawQueue
+    {
+    public:
+        static constexpr uiw VertexArraysLimit = 4;
+
+        static constexpr ui32 LayerBits = 4, RenderTargetBits = 6, ShaderBits = 12, PipelineStateBits = 12, MaterialBits = 14, DepthBits = 16;
+        static constexpr ui32 DepthShift = 0, MaterialShift = DepthShift + DepthBits, PipelineStateShift = MaterialShift + MaterialBits, ShaderShift = PipelineStateShift + PipelineStateBits, RenderTargetShift = ShaderShift + ShaderBits, LayerShift = RenderTargetShift + RenderTargetBits;
+        static_assert(LayerShift + LayerBits == 64);
+        static constexpr ui32 LayersCount = 1u << LayerBits;
+        static constexpr ui64 StateMask = ~((1ull << DepthBits) - 1); // everything but the depth
+
+        struct SortEntry
+        {
+            ui64 key;
+            ui32 index;
+        };
+
+        struct DrawDesc
+        {
+            const Camera *camera = nullptr;
+            const RendererPipelineState *pipelineState = nullptr;
+            const Material *material = nullptr;
+            array<shared_ptr<const RendererVertexArray>, VertexArraysLimit> vertexArrays{};
+            shared_ptr<const RendererIndexArray> indexArray{}; // the draw is indexed if it's set
+            optional<Matrix4x3> modelMatrix{};
+            PrimitiveTopology topology = PrimitiveTopology::TriangleEnumeration;
+            ui32 count = 0; // vertices or indexes
+            ui32 instanceCount = 1;
+            f32 depth = 0; // in [0; 1], smaller is drawn first within the same state
+            ui8 layer = 0; // less than LayersCount, bigger values are clamped
+        };
+
+    private:
+        static constexpr ui32 CategoryBits[] = {RenderTargetBits, ShaderBits, PipelineStateBits, MaterialBits};
+
+        // ids are valid only in the generation they've been assigned in, so Clear doesn't free the nodes and a steady frame doesn't allocate
+        struct Id
+        {
+            ui32 id;
+            ui32 generation;
+        };
+
+        vector<DrawDesc> _draws{};
+        vector<SortEntry> _entries{};
+        vector<SortEntry> _scratch{};
+        std::unordered_map<const void *, Id> _ids[4]{}; // render targets, shaders, pipeline states, materials
+        array<ui32, 4> _nextIds{};
+        ui32 _generation = 0;
+        bool _isSorted = true;
+
+    public:
+        void Clear(); // the memory is kept for the next frame
+        void Add(DrawDesc &&draw);
+        void Sort();
+        ui32 WriteTo(RendererCommandBuffer &buffer) const; // writes the draws in the current order, state commands are written only when the state changes, returns their number
+        [[nodiscard]] uiw Size() const;
+        [[nodiscard]] span<const SortEntry> Entries() const;
+
+        [[nodiscard]] static ui64 Key(ui32 layer, ui32 renderTarget, ui32 shader, ui32 pipelineState, ui32 material, f32 depth);
+        // stable LSD radix sort with 8-bit digits, passes where all keys share the digit are skipped, scratch is resized as needed
+        static void RadixSort(span<SortEntry> entries, vector<SortEntry> &scratch);
+        // the number of neighbouring keys with a different state, an estimate of the state changes the order produces
+        [[nodiscard]] static ui32 CountStateChanges(span<const SortEntry> entries);
+
+    private:
+        ui32 IdOf(uiw category, const void *object);
+    };
+}
\ No newline at end of file
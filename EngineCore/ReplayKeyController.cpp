@@ -0,0 +1,141 @@
+#include "BasicHeader.hpp"
+#include "ReplayKeyController.hpp"
+#include "Logger.hpp"
+
+using namespace EngineCore;
+
+ReplayKeyController::ReplayKeyController(const shared_ptr<IKeyController> &nextController, MemoryMappedFile &&log) : _nextController(nextController), _log(move(log))
+{
+    ASSUME(nextController);
+}
+
+shared_ptr<ReplayKeyController> ReplayKeyController::New(const shared_ptr<IKeyController> &nextController, const FilePath &logPath)
+{
+    File file = File(logPath, FileOpenMode::OpenExisting, FileProcModes::Read);
+    if (!file.IsOpen())
+    {
+        SENDLOG(Error, "ReplayKeyController failed to open file " PTHSTR "\n", logPath.PlatformPath().data());
+        return nullptr;
+    }
+
+    MemoryMappedFile log = MemoryMappedFile(file);
+    if (!log.IsOpen() || log.Size() < sizeof(ControlActionsLog::Header))
+    {
+        SENDLOG(Error, "ReplayKeyController failed to map file " PTHSTR "\n", logPath.PlatformPath().data());
+        return nullptr;
+    }
+
+    ControlActionsLog::Header header;
+    MemOps::Copy((ui8 *)&header, log.CMemory(), sizeof(header));
+    if (header.signature != ControlActionsLog::Header::SignatureValue || header.version != ControlActionsLog::Header::CurrentVersion)
+    {
+        SENDLOG(Error, "ReplayKeyController file " PTHSTR " has unsupported format\n", logPath.PlatformPath().data());
+        return nullptr;
+    }
+
+    struct Proxy : public ReplayKeyController
+    {
+        Proxy(const shared_ptr<IKeyController> &nextController, MemoryMappedFile &&log) : ReplayKeyController(nextController, move(log)) {}
+    };
+    return make_shared<Proxy>(nextController, move(log));
+}
+
+void ReplayKeyController::Dispatch(const ControlAction &action)
+{
+    // live input would make the replay non-deterministic
+}
+
+void ReplayKeyController::Dispatch(span<const ControlAction> actions)
+{
+}
+
+void ReplayKeyController::Update()
+{
+    return _nextController->Update();
+}
+
+auto ReplayKeyController::GetKeyInfo(KeyCode key, DeviceTypes::DeviceType device) const -> KeyInfo
+{
+    return _nextController->GetKeyInfo(key, device);
+}
+
+auto ReplayKeyController::GetPositionInfo(DeviceTypes::DeviceType device) const -> optional<i32Vector2>
+{
+    return _nextController->GetPositionInfo(device);
+}
+
+auto ReplayKeyController::GetAllKeyStates(DeviceTypes::DeviceType device) const -> const AllKeyStates &
+{
+    return _nextController->GetAllKeyStates(device);
+}
+
+auto ReplayKeyController::OnControlAction(const ListenerCallbackType &callback, DeviceTypes::DeviceType deviceMask, ControlActionKinds::ControlActionKind kindMask) -> ListenerHandle
+{
+    return _nextController->OnControlAction(callback, deviceMask, kindMask);
+}
+
+void ReplayKeyController::RemoveListener(ListenerHandle &handle)
+{
+    return _nextController->RemoveListener(handle);
+}
+
+void ReplayKeyController::Advance(TimeDifference delta)
+{
+    _replayMoment = _replayMoment + delta;
+
+    array<ControlAction, 64> batch;
+    uiw batchSize = 0;
+
+    while (_isPendingAction || DecodeNext())
+    {
+        if (_pendingAction.occuredAt > _replayMoment)
+        {
+            break;
+        }
+
+        batch[batchSize++] = _pendingAction;
+        _isPendingAction = false;
+
+        if (batchSize == batch.size())
+        {
+            _nextController->Dispatch(span<const ControlAction>(batch.data(), batchSize));
+            batchSize = 0;
+        }
+    }
+
+    if (batchSize)
+    {
+        _nextController->Dispatch(span<const ControlAction>(batch.data(), batchSize));
+    }
+}
+
+bool ReplayKeyController::IsFinished() const
+{
+    return _isFinished && !_isPendingAction;
+}
+
+bool ReplayKeyController::DecodeNext()
+{
+    if (_isFinished)
+    {
+        return false;
+    }
+
+    if (_offset == _log.Size())
+    {
+        _isFinished = true;
+        return false;
+    }
+
+    uiw consumed = ControlActionsLog::Decode(_log.CMemory() + _offset, _log.Size() - _offset, _lastDecodedMoment, _pendingAction);
+    if (consumed == 0)
+    {
+        SENDLOG(Warning, "ReplayKeyController found a truncated or malformed action at offset %u, the rest of the log is skipped\n", (ui32)_offset);
+        _isFinished = true;
+        return false;
+    }
+
+    _offset += consumed;
+    _isPendingAction = true;
+    return true;
+}
\ No newline at end of file
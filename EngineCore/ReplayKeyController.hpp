@@ -0,0 +1,47 @@
+#pragma once
+
+#include "IKeyController.hpp"
+#include "ControlActionsLog.hpp"
+
+namespace EngineCore
+{
+    // feeds actions recorded by RecordingKeyController into the next controller, live actions are ignored
+    // the log is memory mapped, so replaying doesn't allocate regardless of its length
+    class ReplayKeyController : public std::enable_shared_from_this<ReplayKeyController>, public IKeyController
+    {
+    protected:
+        ReplayKeyController(const shared_ptr<IKeyController> &nextController, MemoryMappedFile &&log);
+        ReplayKeyController(ReplayKeyController &&) = delete;
+        ReplayKeyController &operator = (ReplayKeyController &&) = delete;
+
+    public:
+        static shared_ptr<ReplayKeyController> New(const shared_ptr<IKeyController> &nextController, const FilePath &logPath); // returns nullptr if the log cannot be opened
+
+        virtual ~ReplayKeyController() override = default;
+        virtual void Dispatch(const ControlAction &action) override;
+        virtual void Dispatch(span<const ControlAction> actions) override;
+        virtual void Update() override;
+        [[nodiscard]] virtual KeyInfo GetKeyInfo(KeyCode key, DeviceTypes::DeviceType device = DeviceTypes::MouseKeyboard) const override;
+        [[nodiscard]] virtual optional<i32Vector2> GetPositionInfo(DeviceTypes::DeviceType device = DeviceTypes::MouseKeyboard) const override;
+        [[nodiscard]] virtual const AllKeyStates &GetAllKeyStates(DeviceTypes::DeviceType device = DeviceTypes::MouseKeyboard) const override;
+        [[nodiscard]] virtual ListenerHandle OnControlAction(const ListenerCallbackType &callback, DeviceTypes::DeviceType deviceMask, ControlActionKinds::ControlActionKind kindMask = ControlActionKinds::_All) override;
+        virtual void RemoveListener(ListenerHandle &handle) override;
+
+        // dispatches the recorded actions that occured within delta after the previous call,
+        // the same sequence of deltas always produces the same sequence of dispatches
+        void Advance(TimeDifference delta);
+        [[nodiscard]] bool IsFinished() const;
+
+    private:
+        bool DecodeNext();
+
+        shared_ptr<IKeyController> _nextController{};
+        MemoryMappedFile _log{};
+        uiw _offset = sizeof(ControlActionsLog::Header);
+        TimeMoment _lastDecodedMoment = TimeMoment::Now(); // the recorded deltas are accumulated here
+        TimeMoment _replayMoment = _lastDecodedMoment;
+        ControlAction _pendingAction{}; // decoded, but its moment hasn't come yet
+        bool _isPendingAction = false;
+        bool _isFinished = false;
+    };
+}
\ No newline at end of file
@@ -1,11 +1,22 @@
 #pragma once
 
+// what happens when an element is pushed into a full buffer
+enum class RingBufferOverflowPolicy
+{
+	Overwrite, // the oldest element gets replaced, counted as dropped
+	Reject, // the new element is discarded, counted as dropped
+	Block // the producer waits until the consumer frees some space, requires a concurrent consumer
+};
+
 // a simple implementation only for POD types
-template <typename T, uiw MaxElements> class RingBuffer
+template <typename T, uiw MaxElements, RingBufferOverflowPolicy Policy = RingBufferOverflowPolicy::Overwrite> class RingBuffer
 {
     static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>, "only trivial types are allowed for this implementation");
+    static_assert(Policy != RingBufferOverflowPolicy::Block, "Block requires a concurrent consumer, use SPSCRingBuffer for it");
 
-	static constexpr bool isOverflowWrapped = MaxElements == 256 || MaxElements == 65536;
+	// any power of two size uses mask arithmetic instead of a branch, 256 and 65536 also wrap naturally with their index types
+	static constexpr bool isPowerOfTwo = (MaxElements & (MaxElements - 1)) == 0;
+	static constexpr uiw IndexMask = MaxElements - 1;
 	using indexType = 
         conditional_t<MaxElements == 65536, ui16, 
         conditional_t<MaxElements == 256, ui8,
@@ -17,6 +28,8 @@ template <typename T, uiw MaxElements> class RingBuffer
 	// if _head == _tail when _isEmtpy == 0, then there's only one element, in all other cases, _head won't be equal _tail
 	// the buffer grows into positive values
 	indexType _isEmtpy = 1;
+	uiw _droppedCount = 0; // elements that were either overwritten or rejected
+	uiw _highWatermark = 0; // the biggest size the buffer has ever had
 
 	/*
 	----------------------------
@@ -26,32 +39,31 @@ template <typename T, uiw MaxElements> class RingBuffer
 
 	static indexType AdvanceForward(indexType value)
 	{
-		if (false == isOverflowWrapped && value == MaxElements - 1)
+		if constexpr (isPowerOfTwo)
 		{
-			value = 0;
+			return (indexType)((value + 1) & IndexMask);
 		}
 		else
 		{
-			++value;
+			return value == MaxElements - 1 ? (indexType)0 : (indexType)(value + 1);
 		}
-		return value;
 	}
 
 	static indexType AdvanceBackward(indexType value)
 	{
-		if (false == isOverflowWrapped && value == 0)
+		if constexpr (isPowerOfTwo)
 		{
-			value = MaxElements - 1;
+			return (indexType)((value - 1) & IndexMask);
 		}
 		else
 		{
-			--value;
+			return value == 0 ? (indexType)(MaxElements - 1) : (indexType)(value - 1);
 		}
-		return value;
 	}
 
 public:
 	static constexpr uiw MaxElements = MaxElements;
+	static constexpr RingBufferOverflowPolicy Policy = Policy;
 
     RingBuffer() = default;
 
@@ -61,6 +73,11 @@ public:
 		_head = _tail;
 	}
 
+	bool empty() const
+	{
+		return _isEmtpy != 0;
+	}
+
 	uiw size() const
 	{
 		if (_isEmtpy)
@@ -74,8 +91,40 @@ public:
 		return (uiw)_head + MaxElements - (uiw)_tail + 1;
 	}
 
-	void push_back(const T &value)
+	// counters survive clear()
+	uiw dropped_count() const
+	{
+		return _droppedCount;
+	}
+
+	uiw high_watermark() const
+	{
+		return _highWatermark;
+	}
+
+	void reset_counters()
 	{
+		_droppedCount = 0;
+		_highWatermark = size();
+	}
+
+	// returns false if the value has been rejected, an overwrite of the oldest element isn't a failure
+	[[nodiscard]] bool try_push(const T &value)
+	{
+		uiw currentSize = size();
+		if (currentSize == MaxElements)
+		{
+			++_droppedCount;
+			if constexpr (Policy == RingBufferOverflowPolicy::Reject)
+			{
+				return false;
+			}
+		}
+		else
+		{
+			_highWatermark = std::max(_highWatermark, currentSize + 1);
+		}
+
 		if (!_isEmtpy)
 		{
 			_head = AdvanceForward(_head);
@@ -86,6 +135,12 @@ public:
 			_tail = AdvanceForward(_tail);
 		}
 		_isEmtpy = 0;
+		return true;
+	}
+
+	void push_back(const T &value)
+	{
+		[[maybe_unused]] bool isPushed = try_push(value);
 	}
 
 	void pop_back()
@@ -101,25 +156,44 @@ public:
 		}
 	}
 
-	template <typename T = T, uiw MaxElements = MaxElements, typename IndexType = indexType> class _const_iterator : public std::iterator<std::forward_iterator_tag, T>
+	// the most recently added element
+	T &back()
 	{
-		static constexpr bool isOverflowWrapped = MaxElements == 256 || MaxElements == 65536;
+		assert(_isEmtpy == 0);
+		return _elements[_head];
+	}
 
+	const T &back() const
+	{
+		assert(_isEmtpy == 0);
+		return _elements[_head];
+	}
+
+	// the stored elements from the oldest to the newest as at most two contiguous parts,
+	// the second part is empty unless the elements wrap around the end of the storage
+	// prefer it over the iterators when the elements can be processed in bulk
+	array<span<const T>, 2> spans() const
+	{
+		if (_isEmtpy)
+		{
+			return {};
+		}
+		if (_head >= _tail)
+		{
+			return {span<const T>(_elements.data() + _tail, (uiw)_head - (uiw)_tail + 1), span<const T>()};
+		}
+		return {span<const T>(_elements.data() + _tail, MaxElements - (uiw)_tail), span<const T>(_elements.data(), (uiw)_head + 1)};
+	}
+
+	template <typename T = T, uiw MaxElements = MaxElements, typename IndexType = indexType> class _const_iterator : public std::iterator<std::forward_iterator_tag, T>
+	{
 		const T *_elements;
 		IndexType _head, _tail;
 		IndexType _isEmpty;
 
 		static IndexType AdvanceForward(IndexType value)
 		{
-			if (false == isOverflowWrapped && value == MaxElements - 1)
-			{
-				value = 0;
-			}
-			else
-			{
-				++value;
-			}
-			return value;
+			return RingBuffer::AdvanceForward(value);
 		}
 
 	public:
@@ -140,7 +214,7 @@ public:
 			return *this;
 		}
 
-        _const_iterator &operator ++ (int)
+        _const_iterator operator ++ (int)
 		{
 			auto ret = *this;
 			this->operator++();
@@ -164,7 +238,7 @@ public:
 
 		const T *operator ->() const
 		{
-			return _elements[_head];
+			return _elements + _head;
 		}
 	};
 
@@ -189,4 +263,189 @@ public:
 	{
 		return const_iterator(_elements.data(), _head, _head, 1);
 	}
-};
\ No newline at end of file
+};
+
+// lock-free single producer single consumer version, only POD types as well
+// one thread may only push, another one may only pop, size() is approximate when called concurrently
+// the buffer never overwrites elements, when it's full a push either fails or waits for the consumer depending on Policy
+template <typename T, uiw MaxElements, RingBufferOverflowPolicy Policy = RingBufferOverflowPolicy::Reject> class SPSCRingBuffer
+{
+	static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>, "only trivial types are allowed for this implementation");
+	static_assert(Policy != RingBufferOverflowPolicy::Overwrite, "the producer cannot overwrite elements the consumer may be reading");
+	static_assert(MaxElements > 0 && (MaxElements & (MaxElements - 1)) == 0, "MaxElements must be a power of two");
+
+	static constexpr uiw CacheLineSize = 64;
+	static constexpr uiw IndexMask = MaxElements - 1;
+
+	// counters are never wrapped, actual indexes are computed with IndexMask
+	// producer and consumer data live on separate cache lines to avoid false sharing
+	alignas(CacheLineSize) atomic<uiw> _head = 0; // number of pushed elements, written only by the producer
+	uiw _producerCachedTail = 0; // last seen _tail, the producer rereads _tail only when the buffer looks full
+	atomic<uiw> _droppedCount = 0; // written only by the producer
+	atomic<uiw> _highWatermark = 0; // written only by the producer, computed against _producerCachedTail, so it may overestimate
+	alignas(CacheLineSize) atomic<uiw> _tail = 0; // number of popped elements, written only by the consumer
+	uiw _consumerCachedHead = 0; // last seen _head, the consumer rereads _head only when the buffer looks empty
+	alignas(CacheLineSize) array<T, MaxElements> _elements;
+
+	// copies count elements into the ring starting at counter, handles wrapping
+	void CopyIn(uiw counter, const T *source, uiw count)
+	{
+		uiw index = counter & IndexMask;
+		uiw firstPart = std::min(count, MaxElements - index);
+		MemOps::Copy(_elements.data() + index, source, firstPart);
+		MemOps::Copy(_elements.data(), source + firstPart, count - firstPart);
+	}
+
+	void CopyOut(uiw counter, T *target, uiw count) const
+	{
+		uiw index = counter & IndexMask;
+		uiw firstPart = std::min(count, MaxElements - index);
+		MemOps::Copy(target, _elements.data() + index, firstPart);
+		MemOps::Copy(target + firstPart, _elements.data(), count - firstPart);
+	}
+
+	// producer side, returns how many elements can be pushed right now
+	uiw FreeSpace(uiw head, uiw required)
+	{
+		uiw freeSpace = MaxElements - (head - _producerCachedTail);
+		if (freeSpace < required)
+		{
+			_producerCachedTail = _tail.load(std::memory_order_acquire);
+			freeSpace = MaxElements - (head - _producerCachedTail);
+		}
+		return freeSpace;
+	}
+
+	// producer side, the buffer contains newHead - _producerCachedTail elements at most
+	void UpdateHighWatermark(uiw newHead)
+	{
+		uiw currentSize = newHead - _producerCachedTail;
+		if (currentSize > _highWatermark.load(std::memory_order_relaxed))
+		{
+			_highWatermark.store(currentSize, std::memory_order_relaxed);
+		}
+	}
+
+	// consumer side, returns how many elements can be popped right now
+	uiw Available(uiw tail, uiw required)
+	{
+		uiw available = _consumerCachedHead - tail;
+		if (available < required)
+		{
+			_consumerCachedHead = _head.load(std::memory_order_acquire);
+			available = _consumerCachedHead - tail;
+		}
+		return available;
+	}
+
+public:
+	static constexpr uiw MaxElements = MaxElements;
+
+	SPSCRingBuffer() = default;
+	SPSCRingBuffer(SPSCRingBuffer &&) = delete;
+	SPSCRingBuffer &operator = (SPSCRingBuffer &&) = delete;
+
+	uiw size() const
+	{
+		uiw tail = _tail.load(std::memory_order_acquire);
+		uiw head = _head.load(std::memory_order_acquire);
+		return head - tail;
+	}
+
+	bool empty() const
+	{
+		return size() == 0;
+	}
+
+	uiw dropped_count() const
+	{
+		return _droppedCount.load(std::memory_order_relaxed);
+	}
+
+	uiw high_watermark() const
+	{
+		return _highWatermark.load(std::memory_order_relaxed);
+	}
+
+	// producer only, with the Block policy it never fails
+	[[nodiscard]] bool try_push(const T &value)
+	{
+		uiw head = _head.load(std::memory_order_relaxed);
+		while (FreeSpace(head, 1) == 0)
+		{
+			if constexpr (Policy == RingBufferOverflowPolicy::Reject)
+			{
+				_droppedCount.store(_droppedCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+				return false;
+			}
+			std::this_thread::yield();
+		}
+		_elements[head & IndexMask] = value;
+		_head.store(head + 1, std::memory_order_release);
+		UpdateHighWatermark(head + 1);
+		return true;
+	}
+
+	void push_back(const T &value)
+	{
+		[[maybe_unused]] bool isPushed = try_push(value);
+	}
+
+	// producer only, returns the number of pushed elements
+	// with the Reject policy pushes as many elements as there's free space for and drops the rest
+	// with the Block policy waits until all the elements are pushed
+	uiw push_range(const T *values, uiw count)
+	{
+		uiw head = _head.load(std::memory_order_relaxed);
+		uiw pushed = 0;
+		for (;;)
+		{
+			uiw portion = std::min(count - pushed, FreeSpace(head, count - pushed));
+			if (portion)
+			{
+				CopyIn(head, values + pushed, portion);
+				head += portion;
+				pushed += portion;
+				_head.store(head, std::memory_order_release);
+				UpdateHighWatermark(head);
+			}
+			if (pushed == count)
+			{
+				break;
+			}
+			if constexpr (Policy == RingBufferOverflowPolicy::Reject)
+			{
+				_droppedCount.store(_droppedCount.load(std::memory_order_relaxed) + (count - pushed), std::memory_order_relaxed);
+				break;
+			}
+			std::this_thread::yield();
+		}
+		return pushed;
+	}
+
+	// consumer only
+	[[nodiscard]] bool try_pop(T &value)
+	{
+		uiw tail = _tail.load(std::memory_order_relaxed);
+		if (Available(tail, 1) == 0)
+		{
+			return false;
+		}
+		value = _elements[tail & IndexMask];
+		_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// consumer only, pops up to maxCount elements into target, returns the number of popped elements
+	uiw pop_range(T *target, uiw maxCount)
+	{
+		uiw tail = _tail.load(std::memory_order_relaxed);
+		uiw count = std::min(maxCount, Available(tail, maxCount));
+		if (count)
+		{
+			CopyOut(tail, target, count);
+			_tail.store(tail + count, std::memory_order_release);
+		}
+		return count;
+	}
+};
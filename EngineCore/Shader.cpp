@@ -11,11 +11,12 @@ static bool CheckSystemUniform(Shader &shader, string_view uniformName, ui32 exp
 Shader::Shader(string_view name, string_view vsCode, string_view psCode, const Uniform *uniforms, ui32 uniformsCount, const string_view *inputAttributes, ui32 inputAttributesCount, const Uniform *systemUniforms, ui32 systemUniformsCount) : _uniforms(uniforms, uniforms + uniformsCount), _inputAttributes(inputAttributes, inputAttributes + inputAttributesCount), _systemUniforms(systemUniforms, systemUniforms + systemUniformsCount)
 {
 	_name = name;
+	_nameHash = HashName(Name());
 	_vsSource = vsCode;
 	_psSource = psCode;
 }
 
-shared_ptr<Shader> Shader::New(string_view name, string_view vsCode, string_view psCode, const Uniform *uniforms, ui32 uniformsCount, const string_view *inputAttributes, ui32 inputAttributesCount, const Uniform *systemUniforms, ui32 systemUniformsCount)
+shared_ptr<Shader> Shader::New(string_view name, string_view vsCode, string_view psCode, const Uniform *uniforms, ui32 uniformsCount, const string_view *inputAttributes, ui32 inputAttributesCount, const Uniform *systemUniforms, ui32 systemUniformsCount, const string_view *keywords, ui32 keywordsCount, const ShaderVariantCondition *inputAttributesConditions)
 {
 	struct Proxy : public Shader
 	{
@@ -23,6 +24,13 @@ shared_ptr<Shader> Shader::New(string_view name, string_view vsCode, string_view
 	};
 
 	assert(uniforms != nullptr || uniformsCount == 0);
+	assert(keywords != nullptr || keywordsCount == 0);
+
+	if (keywordsCount > MaxKeywords)
+	{
+		SENDLOG(Error, "Trying to create shader with %u keywords, but only %u are supported, shader name %*s\n", keywordsCount, MaxKeywords, SVIEWARG(name));
+		return nullptr;
+	}
 
 	// TODO: make sure that the name appears only once
 	for (ui32 uniformIndex = 0; uniformIndex < uniformsCount; ++uniformIndex)
@@ -63,7 +71,7 @@ shared_ptr<Shader> Shader::New(string_view name, string_view vsCode, string_view
 		}
 	}
 
-    auto shaderPtr = make_shared<Proxy>(name, vsCode, psCode, uniforms, uniformsCount, inputAttributes, inputAttributesCount, systemUniforms, systemUniformsCount);;
+    auto shaderPtr = make_shared<Proxy>(name, vsCode, psCode, uniforms, uniformsCount, inputAttributes, inputAttributesCount, systemUniforms, systemUniformsCount);
 
     if (false == CheckSystemUniform(*shaderPtr, "_ModelMatrix", 3, 4, Shader::Uniform::Type::F32))
     {
@@ -86,9 +94,137 @@ shared_ptr<Shader> Shader::New(string_view name, string_view vsCode, string_view
         return nullptr;
     }
 
+    if (keywordsCount)
+    {
+        shaderPtr->_keywords.assign(keywords, keywords + keywordsCount);
+        shaderPtr->_variantsSource = make_unique<VariantsSource>();
+        shaderPtr->_variantsSource->uniforms = shaderPtr->_uniforms;
+        shaderPtr->_variantsSource->systemUniforms = shaderPtr->_systemUniforms;
+        shaderPtr->_variantsSource->inputAttributes = shaderPtr->_inputAttributes;
+        if (inputAttributesConditions)
+        {
+            shaderPtr->_variantsSource->inputAttributesConditions.assign(inputAttributesConditions, inputAttributesConditions + inputAttributesCount);
+        }
+        shaderPtr->ApplyVariantKey(*shaderPtr->_variantsSource, 0);
+    }
+
     return shaderPtr;
 }
 
+shared_ptr<Shader> Shader::Variant(const shared_ptr<Shader> &shader, ShaderVariantKey key)
+{
+    if (shader == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (key == shader->_variantKey)
+    {
+        return shader;
+    }
+
+    if (shader->_variantsSource == nullptr)
+    {
+        SENDLOG(Error, "Shader::Variant can't create variant %u of shader %*s, it's either a variant itself or has no keywords\n", key, SVIEWARG(shader->Name()));
+        return nullptr;
+    }
+
+    if (key >> shader->_keywords.size())
+    {
+        SENDLOG(Error, "Shader::Variant received key %u that uses keywords shader %*s doesn't have\n", key, SVIEWARG(shader->Name()));
+        return nullptr;
+    }
+
+    auto &variants = shader->_variantsSource->variants;
+    if (variants.empty())
+    {
+        variants.resize((uiw)1 << shader->_keywords.size());
+    }
+
+    auto &variant = variants[key];
+    if (variant == nullptr)
+    {
+        variant = shader->CreateVariant(key);
+    }
+    return variant;
+}
+
+void Shader::ApplyVariantKey(const VariantsSource &source, ShaderVariantKey key)
+{
+    auto filterUniforms = [key](const vector<Uniform> &uniforms)
+    {
+        vector<Uniform> result;
+        for (const auto &uniform : uniforms)
+        {
+            if (uniform.condition.IsMet(key))
+            {
+                result.push_back(uniform);
+            }
+        }
+        return result;
+    };
+
+    _uniforms = filterUniforms(source.uniforms);
+    _systemUniforms = filterUniforms(source.systemUniforms);
+
+    _inputAttributes.clear();
+    for (uiw index = 0; index < source.inputAttributes.size(); ++index)
+    {
+        if (source.inputAttributesConditions.empty() || source.inputAttributesConditions[index].IsMet(key))
+        {
+            _inputAttributes.push_back(source.inputAttributes[index]);
+        }
+    }
+
+    _variantKey = key;
+}
+
+shared_ptr<Shader> Shader::CreateVariant(ShaderVariantKey key) const
+{
+    ASSUME(_variantsSource != nullptr);
+
+    string name = _name;
+    string defines;
+    for (uiw index = 0; index < _keywords.size(); ++index)
+    {
+        if (key & (1u << index))
+        {
+            name += '+';
+            name += _keywords[index];
+            defines += "#define ";
+            defines += _keywords[index];
+            defines += '\n';
+        }
+    }
+
+    // #version must stay the first directive
+    auto addDefines = [&defines](const string &code)
+    {
+        uiw insertAt = 0;
+        if (code.compare(0, 8, "#version") == 0)
+        {
+            insertAt = code.find('\n');
+            insertAt = insertAt == string::npos ? code.size() : insertAt + 1;
+        }
+        string result = code;
+        result.insert(insertAt, defines);
+        return result;
+    };
+
+    string vsCode = addDefines(_vsSource);
+    string psCode = addDefines(_psSource);
+
+    // the interface is filtered after the creation, it's a subset of the base shader's one, so it's valid as well
+    const auto &source = *_variantsSource;
+    auto variant = New(name, vsCode, psCode);
+    if (variant != nullptr)
+    {
+        variant->_keywords = _keywords;
+        variant->ApplyVariantKey(source, key);
+    }
+    return variant;
+}
+
 string_view Shader::VSCode() const
 {
 	return _vsSource;
@@ -123,6 +259,38 @@ string_view Shader::Name() const
 	return _name;
 }
 
+size_t Shader::NameHash() const
+{
+	return _nameHash;
+}
+
+const vector<string> &Shader::Keywords() const
+{
+	return _keywords;
+}
+
+ShaderVariantKey Shader::VariantKey() const
+{
+	return _variantKey;
+}
+
+size_t Shader::HashName(string_view name)
+{
+	return std::hash<string_view>()(name);
+}
+
+auto Shader::FindSystemUniformSlot(string_view name) -> optional<SystemUniformSlot>
+{
+	for (uiw index = 0; index < SystemUniformSlotNames.size(); ++index)
+	{
+		if (SystemUniformSlotNames[index] == name)
+		{
+			return (SystemUniformSlot)index;
+		}
+	}
+	return nullopt;
+}
+
 auto FindUniformByName(string_view name, const vector<Shader::Uniform> &uniforms)
 {
     auto findFunc = [name](const Shader::Uniform &uniform)
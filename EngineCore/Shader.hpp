@@ -10,9 +10,61 @@ namespace EngineCore
 	// or they'll be used as initial default values for uniforms with default values
 	// TODO: the implementation is a prototype and is VERY suboptimal
 
+	// a set of keywords, bit N is set if the keyword N of the shader's keyword table is enabled
+	using ShaderVariantKey = ui32;
+
+	// keyword tables are declared as constexpr next to the shaders, so variant keys are computed at compile time
+	// and using an unknown keyword in a constant expression fails to compile
+	template <uiw Count> class ShaderKeywordTable
+	{
+		array<string_view, Count> _names;
+
+		static ShaderVariantKey UnknownKeyword() { return 0; }
+
+	public:
+		template <typename... Names> constexpr ShaderKeywordTable(Names... names) : _names{names...} {}
+
+		constexpr ShaderVariantKey Key(string_view keyword) const
+		{
+			for (uiw index = 0; index < Count; ++index)
+			{
+				if (_names[index] == keyword)
+				{
+					return 1u << index;
+				}
+			}
+			return UnknownKeyword();
+		}
+
+		template <typename... Keywords> constexpr ShaderVariantKey Key(string_view keyword, Keywords... keywords) const
+		{
+			return Key(keyword) | Key(keywords...);
+		}
+
+		constexpr const array<string_view, Count> &Names() const
+		{
+			return _names;
+		}
+	};
+
+	template <typename... Names> ShaderKeywordTable(Names...) -> ShaderKeywordTable<sizeof...(Names)>;
+
+	// a part of the shader's interface that exists only in some of its variants
+	struct ShaderVariantCondition
+	{
+		ShaderVariantKey required = 0, excluded = 0;
+
+		constexpr bool IsMet(ShaderVariantKey key) const
+		{
+			return (key & required) == required && (key & excluded) == 0;
+		}
+	};
+
 	class Shader : public RendererFrontendData
 	{
 	public:
+		static constexpr ui32 MaxKeywords = 8;
+
 		struct Uniform
 		{
 			enum class Type : ui16
@@ -28,8 +80,23 @@ namespace EngineCore
 			string_view name;
 			ui16 elementWidth, elementHeight, elementsCount; // mat4x3[2] will have elementWidth == 3, elementHeight == 4 and elementsCount == 2, elementWidth and elementHeight must be equal 1 for non-vector types
 			Type type;
+			ShaderVariantCondition condition{};
 		};
 
+		// system uniforms the renderer provides, a renderer resolves them into a slot table once per shader instead of searching by name on every draw
+		enum class SystemUniformSlot : ui8
+		{
+			ModelMatrix, ViewMatrix, ProjectionMatrix, ViewProjectionMatrix, CameraPosition, CameraForwardVector, CameraRightVector, CameraUpVector,
+			_size
+		};
+
+		static constexpr array<string_view, (uiw)SystemUniformSlot::_size> SystemUniformSlotNames
+		{
+			"_ModelMatrix", "_ViewMatrix", "_ProjectionMatrix", "_ViewProjectionMatrix", "_CameraPosition", "_CameraForwardVector", "_CameraRightVector", "_CameraUpVector"
+		};
+
+		static optional<SystemUniformSlot> FindSystemUniformSlot(string_view name);
+
 	private:
 		friend class Material;
 
@@ -39,6 +106,20 @@ namespace EngineCore
         string _uniformNames{};
         string _vsSource{}, _psSource{};
         string _name{};
+        size_t _nameHash{};
+        vector<string> _keywords{};
+        ShaderVariantKey _variantKey = 0;
+
+        // only the base shader of a shader with keywords has these, its own interface is the one of the variant 0
+        struct VariantsSource
+        {
+            vector<Uniform> uniforms{};
+            vector<Uniform> systemUniforms{};
+            vector<string> inputAttributes{};
+            vector<ShaderVariantCondition> inputAttributesConditions{};
+            vector<shared_ptr<Shader>> variants{}; // indexed by the key, created on demand
+        };
+        unique_ptr<VariantsSource> _variantsSource{};
 
 		Shader(Shader &&) = delete;
 		Shader &operator = (Shader &&) = delete;
@@ -46,8 +127,16 @@ namespace EngineCore
 	protected:
 		Shader(string_view name, string_view vsCode, string_view psCode, const Uniform *uniforms, ui32 uniformsCount, const string_view *inputAttributes, ui32 inputAttributesCount, const Uniform *systemUniforms, ui32 systemUniformsCount);
 
+		void ApplyVariantKey(const VariantsSource &source, ShaderVariantKey key);
+		shared_ptr<Shader> CreateVariant(ShaderVariantKey key) const;
+
 	public:
-		static shared_ptr<Shader> New(string_view name, string_view vsCode, string_view psCode, const Uniform *uniforms = nullptr, ui32 uniformsCount = 0, const string_view *inputAttributes = nullptr, ui32 inputAttributesCount = 0, const Uniform *systemUniforms = nullptr, ui32 systemUniformsCount = 0);
+		// keywords become #defines in variants, uniforms and input attributes whose conditions aren't met by a variant are excluded from it
+		// inputAttributesConditions is either nullptr or has inputAttributesCount elements
+		static shared_ptr<Shader> New(string_view name, string_view vsCode, string_view psCode, const Uniform *uniforms = nullptr, ui32 uniformsCount = 0, const string_view *inputAttributes = nullptr, ui32 inputAttributesCount = 0, const Uniform *systemUniforms = nullptr, ui32 systemUniformsCount = 0, const string_view *keywords = nullptr, ui32 keywordsCount = 0, const ShaderVariantCondition *inputAttributesConditions = nullptr);
+
+		// returns the shader itself for key 0 and nullptr for nullptr shader, variants are created on the first request, after that it's a table lookup
+		static shared_ptr<Shader> Variant(const shared_ptr<Shader> &shader, ShaderVariantKey key);
 
 		string_view VSCode() const;
 		string_view PSCode() const;
@@ -55,5 +144,28 @@ namespace EngineCore
         const vector<Uniform> &SystemUniforms() const;
         const vector<string> &InputAttributes() const;
 		string_view Name() const;
+		size_t NameHash() const;
+		const vector<string> &Keywords() const;
+		ShaderVariantKey VariantKey() const;
+
+		static size_t HashName(string_view name);
+	};
+
+	// non-owning reference to a shader, ShadersManager keeps the shaders it creates alive for the whole application's lifetime,
+	// so handles to them are always valid, use it instead of copying shared_ptr<Shader> where the shader's lifetime is already guaranteed
+	class ShaderHandle
+	{
+		const Shader *_shader = nullptr;
+
+	public:
+		ShaderHandle() = default;
+		ShaderHandle(const shared_ptr<Shader> &shader) : _shader(shader.get()) {}
+
+		const Shader *Get() const { return _shader; }
+		const Shader *operator -> () const { return _shader; }
+		const Shader &operator * () const { return *_shader; }
+		explicit operator bool() const { return _shader != nullptr; }
+		bool operator == (const ShaderHandle &other) const { return _shader == other._shader; }
+		bool operator != (const ShaderHandle &other) const { return _shader != other._shader; }
 	};
 }
\ No newline at end of file
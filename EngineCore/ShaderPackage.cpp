@@ -0,0 +1,369 @@
+#include "BasicHeader.hpp"
+#include "ShaderPackage.hpp"
+#include "Logger.hpp"
+
+using namespace EngineCore;
+using namespace ShaderPackage;
+
+namespace
+{
+    constexpr ui32 AlignUp(ui32 value)
+    {
+        return (value + 7) & ~7u;
+    }
+
+    class StringPool
+    {
+        vector<ui8> _data{};
+
+    public:
+        StringRef Add(string_view str)
+        {
+            StringRef ref{(ui32)_data.size(), (ui32)str.size()};
+            _data.insert(_data.end(), (const ui8 *)str.data(), (const ui8 *)str.data() + str.size());
+            return ref;
+        }
+
+        const vector<ui8> &Data() const
+        {
+            return _data;
+        }
+    };
+
+    template <typename T> void Write(vector<ui8> &target, ui32 offset, const T &value)
+    {
+        MemOps::Copy(target.data() + offset, (const ui8 *)&value, sizeof(T));
+    }
+
+    // string pool offsets are relative to the pool while building, this makes them file relative
+    StringRef Rebase(StringRef ref, ui32 poolOffset)
+    {
+        return {ref.offset + poolOffset, ref.length};
+    }
+}
+
+ui64 ShaderPackage::HashName(string_view name)
+{
+    // FNV-1a
+    ui64 hash = 14695981039346656037ull;
+    for (char ch : name)
+    {
+        hash ^= (ui8)ch;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool Builder::Add(const ShaderDescription &description)
+{
+    auto searchResult = std::find_if(_shaders.begin(), _shaders.end(), [&description](const ShaderDescription &shader) { return shader.name == description.name; });
+    if (searchResult != _shaders.end())
+    {
+        SENDLOG(Error, "ShaderPackage::Builder already has shader %*s\n", SVIEWARG(description.name));
+        return false;
+    }
+    _shaders.push_back(description);
+    return true;
+}
+
+vector<ui8> Builder::Serialize() const
+{
+    vector<ShaderDescription> shaders = _shaders;
+    std::sort(shaders.begin(), shaders.end(), [](const ShaderDescription &left, const ShaderDescription &right) { return HashName(left.name) < HashName(right.name); });
+
+    ui32 uniformsCount = 0, attributesCount = 0, stringRefsCount = 0;
+    for (const auto &shader : shaders)
+    {
+        uniformsCount += (ui32)(shader.uniforms.size() + shader.systemUniforms.size());
+        attributesCount += (ui32)shader.inputAttributes.size();
+        stringRefsCount += (ui32)shader.keywords.size();
+    }
+
+    ui32 indexOffset = sizeof(Header);
+    ui32 recordsOffset = indexOffset + (ui32)shaders.size() * sizeof(IndexEntry);
+    ui32 uniformsOffset = recordsOffset + (ui32)shaders.size() * sizeof(ShaderRecord);
+    ui32 attributesOffset = uniformsOffset + uniformsCount * sizeof(UniformRecord);
+    ui32 stringRefsOffset = attributesOffset + attributesCount * sizeof(AttributeRecord);
+    ui32 poolOffset = AlignUp(stringRefsOffset + stringRefsCount * sizeof(StringRef));
+
+    StringPool pool;
+    vector<ui8> file(poolOffset);
+
+    auto writeUniforms = [&](span<const Shader::Uniform> uniforms, ui32 &offset, ui32 &count)
+    {
+        offset = uniformsOffset;
+        count = (ui32)uniforms.size();
+        for (const auto &uniform : uniforms)
+        {
+            Write(file, uniformsOffset, UniformRecord{Rebase(pool.Add(uniform.name), poolOffset), uniform.elementWidth, uniform.elementHeight, uniform.elementsCount, uniform.type, uniform.condition});
+            uniformsOffset += sizeof(UniformRecord);
+        }
+    };
+
+    auto writeAttributes = [&](const ShaderDescription &shader, ui32 &offset, ui32 &count)
+    {
+        ASSUME(shader.inputAttributesConditions.empty() || shader.inputAttributesConditions.size() == shader.inputAttributes.size());
+        offset = attributesOffset;
+        count = (ui32)shader.inputAttributes.size();
+        for (uiw index = 0; index < shader.inputAttributes.size(); ++index)
+        {
+            ShaderVariantCondition condition = shader.inputAttributesConditions.empty() ? ShaderVariantCondition{} : shader.inputAttributesConditions[index];
+            Write(file, attributesOffset, AttributeRecord{Rebase(pool.Add(shader.inputAttributes[index]), poolOffset), condition});
+            attributesOffset += sizeof(AttributeRecord);
+        }
+    };
+
+    auto writeStrings = [&](span<const string_view> strings, ui32 &offset, ui32 &count)
+    {
+        offset = stringRefsOffset;
+        count = (ui32)strings.size();
+        for (string_view str : strings)
+        {
+            Write(file, stringRefsOffset, Rebase(pool.Add(str), poolOffset));
+            stringRefsOffset += sizeof(StringRef);
+        }
+    };
+
+    for (uiw index = 0; index < shaders.size(); ++index)
+    {
+        const auto &shader = shaders[index];
+        ui32 recordOffset = recordsOffset + (ui32)index * sizeof(ShaderRecord);
+
+        ShaderRecord record;
+        record.name = Rebase(pool.Add(shader.name), poolOffset);
+        record.vsCode = Rebase(pool.Add(shader.vsCode), poolOffset);
+        record.psCode = Rebase(pool.Add(shader.psCode), poolOffset);
+        writeUniforms(shader.uniforms, record.uniformsOffset, record.uniformsCount);
+        writeUniforms(shader.systemUniforms, record.systemUniformsOffset, record.systemUniformsCount);
+        writeAttributes(shader, record.inputAttributesOffset, record.inputAttributesCount);
+        writeStrings(shader.keywords, record.keywordsOffset, record.keywordsCount);
+        Write(file, recordOffset, record);
+
+        Write(file, indexOffset + (ui32)index * sizeof(IndexEntry), IndexEntry{HashName(shader.name), record.name, recordOffset, 0});
+    }
+
+    file.insert(file.end(), pool.Data().begin(), pool.Data().end());
+
+    Header header;
+    header.fileSize = (ui32)file.size();
+    header.shadersCount = (ui32)shaders.size();
+    Write(file, 0, header);
+
+    return file;
+}
+
+bool Builder::Save(const FilePath &path) const
+{
+    vector<ui8> data = Serialize();
+
+    File file = File(path, FileOpenMode::CreateAlways, FileProcModes::Write);
+    if (!file.IsOpen())
+    {
+        SENDLOG(Error, "ShaderPackage::Builder failed to create file " PTHSTR "\n", path.PlatformPath().data());
+        return false;
+    }
+
+    if (!file.Write(data.data(), (ui32)data.size()))
+    {
+        SENDLOG(Error, "ShaderPackage::Builder failed to write file " PTHSTR "\n", path.PlatformPath().data());
+        return false;
+    }
+
+    return true;
+}
+
+namespace
+{
+    struct ReaderProxy : public Reader
+    {
+        ReaderProxy() = default;
+    };
+}
+
+shared_ptr<Reader> Reader::Open(const FilePath &path)
+{
+    File file = File(path, FileOpenMode::OpenExisting, FileProcModes::Read);
+    if (!file.IsOpen())
+    {
+        // packages are optional, so a missing file isn't a warning, callers decide whether it's an error
+        SENDLOG(Info, "ShaderPackage::Reader failed to open file " PTHSTR "\n", path.PlatformPath().data());
+        return nullptr;
+    }
+
+    MemoryMappedFile mapping = MemoryMappedFile(file);
+    if (!mapping.IsOpen())
+    {
+        SENDLOG(Error, "ShaderPackage::Reader failed to map file " PTHSTR "\n", path.PlatformPath().data());
+        return nullptr;
+    }
+
+    auto reader = FromMemory(mapping.CMemory(), mapping.Size());
+    if (reader == nullptr)
+    {
+        SENDLOG(Error, "ShaderPackage::Reader file " PTHSTR " is malformed or has unsupported format\n", path.PlatformPath().data());
+        return nullptr;
+    }
+    reader->_file = move(mapping);
+    return reader;
+}
+
+shared_ptr<Reader> Reader::FromMemory(const ui8 *data, uiw size)
+{
+    shared_ptr<Reader> reader = make_shared<ReaderProxy>();
+    reader->_data = data;
+    reader->_size = size;
+    if (!reader->Validate())
+    {
+        return nullptr;
+    }
+    return reader;
+}
+
+const ShaderRecord *Reader::Find(string_view name) const
+{
+    ui64 hash = HashName(name);
+    auto index = Index();
+    auto it = std::lower_bound(index.begin(), index.end(), hash, [](const IndexEntry &entry, ui64 value) { return entry.nameHash < value; });
+    for (; it != index.end() && it->nameHash == hash; ++it)
+    {
+        if (String(it->name) == name)
+        {
+            return &Record(*it);
+        }
+    }
+    return nullptr;
+}
+
+auto Reader::Index() const -> span<const IndexEntry>
+{
+    const auto &header = *(const Header *)_data;
+    return {(const IndexEntry *)(_data + sizeof(Header)), header.shadersCount};
+}
+
+auto Reader::Record(const IndexEntry &entry) const -> const ShaderRecord &
+{
+    return *(const ShaderRecord *)(_data + entry.recordOffset);
+}
+
+string_view Reader::String(StringRef ref) const
+{
+    return {(const char *)_data + ref.offset, ref.length};
+}
+
+auto Reader::Uniforms(const ShaderRecord &record) const -> span<const UniformRecord>
+{
+    return {(const UniformRecord *)(_data + record.uniformsOffset), record.uniformsCount};
+}
+
+auto Reader::SystemUniforms(const ShaderRecord &record) const -> span<const UniformRecord>
+{
+    return {(const UniformRecord *)(_data + record.systemUniformsOffset), record.systemUniformsCount};
+}
+
+auto Reader::InputAttributes(const ShaderRecord &record) const -> span<const AttributeRecord>
+{
+    return {(const AttributeRecord *)(_data + record.inputAttributesOffset), record.inputAttributesCount};
+}
+
+auto Reader::Keywords(const ShaderRecord &record) const -> span<const StringRef>
+{
+    return {(const StringRef *)(_data + record.keywordsOffset), record.keywordsCount};
+}
+
+auto Reader::Uniform(const UniformRecord &record) const -> Shader::Uniform
+{
+    return {String(record.name), record.elementWidth, record.elementHeight, record.elementsCount, record.type, record.condition};
+}
+
+bool Reader::Validate() const
+{
+    if (_size < sizeof(Header) || ((uiw)_data & 7) != 0)
+    {
+        return false;
+    }
+
+    const auto &header = *(const Header *)_data;
+    if (header.signature != Header::SignatureValue || header.version != Header::CurrentVersion || header.fileSize != _size)
+    {
+        return false;
+    }
+
+    auto isInRange = [this](ui64 offset, ui64 size)
+    {
+        return offset <= _size && size <= _size - offset;
+    };
+
+    auto isTableValid = [&isInRange](ui32 offset, ui32 count, uiw elementSize)
+    {
+        return (offset & 7) == 0 && isInRange(offset, (ui64)count * elementSize);
+    };
+
+    auto isStringValid = [&isInRange](StringRef ref)
+    {
+        return isInRange(ref.offset, ref.length);
+    };
+
+    if (!isTableValid(sizeof(Header), header.shadersCount, sizeof(IndexEntry)))
+    {
+        return false;
+    }
+
+    ui64 previousHash = 0;
+    for (const auto &entry : Index())
+    {
+        if (entry.nameHash < previousHash || !isStringValid(entry.name) || !isTableValid(entry.recordOffset, 1, sizeof(ShaderRecord)))
+        {
+            return false;
+        }
+        previousHash = entry.nameHash;
+
+        const auto &record = Record(entry);
+        if (!isStringValid(record.name) || !isStringValid(record.vsCode) || !isStringValid(record.psCode) ||
+            !isTableValid(record.uniformsOffset, record.uniformsCount, sizeof(UniformRecord)) ||
+            !isTableValid(record.systemUniformsOffset, record.systemUniformsCount, sizeof(UniformRecord)) ||
+            !isTableValid(record.inputAttributesOffset, record.inputAttributesCount, sizeof(AttributeRecord)) ||
+            !isTableValid(record.keywordsOffset, record.keywordsCount, sizeof(StringRef)))
+        {
+            return false;
+        }
+
+        if (HashName(String(entry.name)) != entry.nameHash || String(entry.name) != String(record.name))
+        {
+            return false;
+        }
+
+        for (const auto &uniforms : {Uniforms(record), SystemUniforms(record)})
+        {
+            for (const auto &uniform : uniforms)
+            {
+                if (!isStringValid(uniform.name) || uniform.type > Shader::Uniform::Type::Bool)
+                {
+                    return false;
+                }
+            }
+        }
+
+        for (const auto &attribute : InputAttributes(record))
+        {
+            if (!isStringValid(attribute.name))
+            {
+                return false;
+            }
+        }
+
+        if (record.keywordsCount > Shader::MaxKeywords)
+        {
+            return false;
+        }
+
+        for (const auto &keyword : Keywords(record))
+        {
+            if (!isStringValid(keyword))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
\ No newline at end of file
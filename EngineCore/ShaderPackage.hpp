@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Shader.hpp"
+
+// shader package, a single file that holds shader sources and their metadata laid out to be used directly after memory mapping
+// the file starts with a Header, followed by Header::shadersCount IndexEntry sorted by name hash,
+// then ShaderRecord, UniformRecord, AttributeRecord and StringRef tables, and the string pool at the end
+// all offsets are relative to the start of the file, all tables are 8 bytes aligned, strings aren't null terminated
+// the format doesn't depend on the graphics API, so packages can be built and inspected without a GL context
+
+namespace EngineCore::ShaderPackage
+{
+    struct StringRef
+    {
+        ui32 offset;
+        ui32 length;
+    };
+
+    struct Header
+    {
+        static constexpr ui32 SignatureValue = 'K' << 24 | 'P' << 16 | 'H' << 8 | 'S';
+        static constexpr ui32 CurrentVersion = 2;
+
+        ui32 signature = SignatureValue;
+        ui32 version = CurrentVersion;
+        ui32 fileSize = 0;
+        ui32 shadersCount = 0;
+    };
+
+    struct IndexEntry
+    {
+        ui64 nameHash;
+        StringRef name;
+        ui32 recordOffset;
+        ui32 padding;
+    };
+
+    struct UniformRecord
+    {
+        StringRef name;
+        ui16 elementWidth, elementHeight, elementsCount;
+        Shader::Uniform::Type type;
+        ShaderVariantCondition condition;
+    };
+
+    struct AttributeRecord
+    {
+        StringRef name;
+        ShaderVariantCondition condition;
+    };
+
+    struct ShaderRecord
+    {
+        StringRef name;
+        StringRef vsCode, psCode;
+        ui32 uniformsOffset, uniformsCount; // UniformRecord
+        ui32 systemUniformsOffset, systemUniformsCount; // UniformRecord
+        ui32 inputAttributesOffset, inputAttributesCount; // AttributeRecord
+        ui32 keywordsOffset, keywordsCount; // StringRef
+    };
+
+    static_assert(sizeof(Header) == 16 && sizeof(IndexEntry) == 24 && sizeof(UniformRecord) == 24 && sizeof(AttributeRecord) == 16 && sizeof(ShaderRecord) == 56, "package structures must not have implicit padding");
+
+    // stable across builds and platforms unlike std::hash, it's a part of the file format
+    [[nodiscard]] ui64 HashName(string_view name);
+
+    // views into the caller's memory, they must stay valid until the Builder is serialized
+    struct ShaderDescription
+    {
+        string_view name;
+        string_view vsCode, psCode;
+        span<const Shader::Uniform> uniforms{};
+        span<const string_view> inputAttributes{};
+        span<const Shader::Uniform> systemUniforms{};
+        span<const string_view> keywords{};
+        span<const ShaderVariantCondition> inputAttributesConditions{}; // either empty or one per input attribute
+    };
+
+    class Builder
+    {
+        vector<ShaderDescription> _shaders{};
+
+    public:
+        bool Add(const ShaderDescription &description); // returns false if a shader with the same name has already been added
+        [[nodiscard]] vector<ui8> Serialize() const;
+        [[nodiscard]] bool Save(const FilePath &path) const;
+    };
+
+    class Reader
+    {
+        MemoryMappedFile _file{};
+        const ui8 *_data = nullptr;
+        uiw _size = 0;
+
+    protected:
+        Reader() = default;
+        Reader(Reader &&) = delete;
+        Reader &operator = (Reader &&) = delete;
+
+    public:
+        static shared_ptr<Reader> Open(const FilePath &path); // returns nullptr if the file is missing or malformed
+        static shared_ptr<Reader> FromMemory(const ui8 *data, uiw size); // data must outlive the Reader
+
+        // the whole file is validated when it's opened, so these don't check bounds
+        [[nodiscard]] const ShaderRecord *Find(string_view name) const;
+        [[nodiscard]] span<const IndexEntry> Index() const;
+        [[nodiscard]] const ShaderRecord &Record(const IndexEntry &entry) const;
+        [[nodiscard]] string_view String(StringRef ref) const;
+        [[nodiscard]] span<const UniformRecord> Uniforms(const ShaderRecord &record) const;
+        [[nodiscard]] span<const UniformRecord> SystemUniforms(const ShaderRecord &record) const;
+        [[nodiscard]] span<const AttributeRecord> InputAttributes(const ShaderRecord &record) const;
+        [[nodiscard]] span<const StringRef> Keywords(const ShaderRecord &record) const;
+        [[nodiscard]] Shader::Uniform Uniform(const UniformRecord &record) const;
+
+    private:
+        [[nodiscard]] bool Validate() const;
+    };
+}
\ No newline at end of file
@@ -1,47 +1,95 @@
 #include "BasicHeader.hpp"
 #include "ShadersManager.hpp"
 #include "Shader.hpp"
-#include <unordered_set>
+#include "ShaderPackage.hpp"
+#include "Logger.hpp"
+#include <unordered_map>
+
+using namespace EngineCore;
 
 namespace
 {
+    // keys point into the registered shader's own name, so names are stored only once
+    // and the hash is computed when the shader is created rather than on every rehash
+    struct RegistryKey
+    {
+        string_view name;
+        size_t hash;
+    };
+
     struct Hasher
     {
-        size_t operator () (const shared_ptr<EngineCore::Shader> &key) const
+        using is_transparent = void;
+
+        size_t operator () (const RegistryKey &key) const
+        {
+            return key.hash;
+        }
+
+        size_t operator () (string_view name) const
         {
-            return std::hash<string_view>()(key->Name());
+            return Shader::HashName(name);
         }
     };
 
     struct Comparer
     {
-        bool operator () (const shared_ptr<EngineCore::Shader> &left, const shared_ptr<EngineCore::Shader> &right) const
+        using is_transparent = void;
+
+        bool operator () (const RegistryKey &left, const RegistryKey &right) const
         {
-            return left->Name() < right->Name();
+            return left.hash == right.hash && left.name == right.name;
         }
-    };
 
-    std::unordered_set<shared_ptr<EngineCore::Shader>, Hasher, Comparer> LoadedShaders;
-}
+        bool operator () (string_view left, const RegistryKey &right) const
+        {
+            return left == right.name;
+        }
 
-#define SHADER_VERSION "#version 400 \n"
+        bool operator () (const RegistryKey &left, string_view right) const
+        {
+            return left.name == right;
+        }
+    };
 
-auto EngineCore::ShadersManager::FindShaderByName(string_view name) -> shared_ptr<Shader>
-{
-    auto searchResult = std::find_if(LoadedShaders.begin(), LoadedShaders.end(),
-        [name](const shared_ptr<EngineCore::Shader> &value)
-    {
-        return value->Name() == name;
-    });
+    std::unordered_map<RegistryKey, shared_ptr<Shader>, Hasher, Comparer> LoadedShaders;
 
-    if (searchResult != LoadedShaders.end())
+    // shaders created from a package reference its memory, so loaded packages are never unmapped, the last loaded one takes precedence
+    vector<shared_ptr<ShaderPackage::Reader>> Packages;
+
+    shared_ptr<Shader> Register(const shared_ptr<Shader> &shader)
     {
-        return *searchResult;
+        if (shader == nullptr)
+        {
+            return nullptr;
+        }
+        auto [it, isInserted] = LoadedShaders.try_emplace(RegistryKey{shader->Name(), shader->NameHash()}, shader);
+        ASSUME(isInserted);
+        return it->second;
     }
+}
 
-    if (name == "Color") // TODO: do something about it
+#define SHADER_VERSION "#version 400 \n"
+
+// filled by the renderer only when the camera changes, the members must stay in this order
+#define SHADER_CAMERA_BLOCK \
+    "layout(std140) uniform CameraBlock\n" \
+    "{\n" \
+    "    mat4x4 _ViewProjectionMatrix;\n" \
+    "    mat4x4 _ProjectionMatrix;\n" \
+    "    mat4x3 _ViewMatrix;\n" \
+    "    vec3 _CameraPosition;\n" \
+    "    vec3 _CameraForwardVector;\n" \
+    "    vec3 _CameraRightVector;\n" \
+    "    vec3 _CameraUpVector;\n" \
+    "};\n"
+
+// used when there's no shader package or the package doesn't have the requested shader
+namespace BuiltinShaders
+{
+    namespace Color
     {
-        string_view vsCode = SHADER_VERSION TOSTR(
+        const string_view VS = SHADER_VERSION TOSTR(
             in int gl_VertexID;
 
             void main()
@@ -51,7 +99,7 @@ auto EngineCore::ShadersManager::FindShaderByName(string_view name) -> shared_pt
             }
         );
 
-        string_view psCode = SHADER_VERSION TOSTR(
+        const string_view PS = SHADER_VERSION TOSTR(
             layout(location = 0) out vec4 OutputColor;
 
             uniform vec4 Color;
@@ -62,18 +110,13 @@ auto EngineCore::ShadersManager::FindShaderByName(string_view name) -> shared_pt
             }
         );
 
-        array<Shader::Uniform, 1> uniforms = {
+        const array<Shader::Uniform, 1> Uniforms{
             {"Color", 4, 1, 1, Shader::Uniform::Type::F32}};
-
-        auto shader = Shader::New(name, vsCode, psCode, uniforms.data(), (ui32)uniforms.size());
-
-        LoadedShaders.emplace(shader);
-
-        return shader;
     }
-    else if (name == "ColoredVertices")
+
+    namespace ColoredVertices
     {
-        string_view vsCode = SHADER_VERSION TOSTR(
+        const string_view VS = SHADER_VERSION TOSTR(
             in int gl_VertexID;
             in vec4 position;
             in vec4 color;
@@ -87,7 +130,7 @@ auto EngineCore::ShadersManager::FindShaderByName(string_view name) -> shared_pt
             }
         );
 
-        string_view psCode = SHADER_VERSION TOSTR(
+        const string_view PS = SHADER_VERSION TOSTR(
             in vec4 procColor;
 
             layout(location = 0) out vec4 OutputColor;
@@ -100,81 +143,34 @@ auto EngineCore::ShadersManager::FindShaderByName(string_view name) -> shared_pt
             }
         );
 
-        array<Shader::Uniform, 1> uniforms{
+        const array<Shader::Uniform, 1> Uniforms{
             {"ColorMul", 4, 1, 1, Shader::Uniform::Type::F32}};
 
-        array<string_view, 2> inputAttributes{"position", "color"};
-
-        auto shader = Shader::New(name, vsCode, psCode, uniforms.data(), (ui32)uniforms.size(), inputAttributes.data(), (ui32)inputAttributes.size());
-
-        LoadedShaders.emplace(shader);
-
-        return shader;
+        const array<string_view, 2> InputAttributes{"position", "color"};
     }
-    else if (name == "Colored3DVertices")
-    {
-        string_view vsCode = SHADER_VERSION TOSTR(
-            in vec4 position;
-            in vec4 color;
-
-            out vec4 procColor;
-
-            uniform mat4x3 _ModelMatrix;
-            uniform mat4x4 _ViewProjectionMatrix;
-
-            void main()
-            {
-                vec3 worldPos = _ModelMatrix * position;
-                vec4 screenPos = _ViewProjectionMatrix * vec4(worldPos, 1.0);
 
-                gl_Position = screenPos;
-
-                procColor = color;
-            }
-        );
-
-        string_view psCode = SHADER_VERSION TOSTR(
-            in vec4 procColor;
-
-            layout(location = 0) out vec4 OutputColor;
-
-            uniform vec4 ColorMul;
-
-            void main()
-            {
-                OutputColor = procColor * ColorMul;
-            }
-        );
-
-        array<Shader::Uniform, 1> uniforms{
-            Shader::Uniform{"ColorMul", 4, 1, 1, Shader::Uniform::Type::F32}};
-
-        array<Shader::Uniform, 2> systemUniforms{
-            Shader::Uniform{"_ModelMatrix", 3, 4, 1, Shader::Uniform::Type::F32},
-            Shader::Uniform{"_ViewProjectionMatrix", 4, 4, 1, Shader::Uniform::Type::F32}};
-
-        array<string_view, 2> inputAttributes{"position", "color"};
-
-        auto shader = Shader::New(name, vsCode, psCode, uniforms.data(), (ui32)uniforms.size(), inputAttributes.data(), (ui32)inputAttributes.size(), systemUniforms.data(), (ui32)systemUniforms.size());
-
-        LoadedShaders.emplace(shader);
-
-        return shader;
-    }
-    else if (name == "Colored3DVerticesInstanced")
+    namespace Colored3DVertices
     {
-        string_view vsCode = SHADER_VERSION TOSTR(
+        constexpr ShaderVariantKey Instanced = BuiltinShaderKeywords::Colored3DVertices.Key("INSTANCED");
+
+        // raw literals because TOSTR can't carry preprocessor directives
+        const string_view VS = SHADER_VERSION SHADER_CAMERA_BLOCK R"(
             in vec4 position;
             in vec4 color;
+        #ifdef INSTANCED
             in vec4 rotation;
             in vec4 wpos_scale;
+        #endif
 
             out vec4 procColor;
 
-            uniform mat4x4 _ViewProjectionMatrix;
+        #ifndef INSTANCED
+            uniform mat4x3 _ModelMatrix;
+        #endif
 
             void main()
             {
+            #ifdef INSTANCED
                 vec4 outColor = color;
 
                 float scale = wpos_scale.w;
@@ -201,39 +197,54 @@ auto EngineCore::ShadersManager::FindShaderByName(string_view name) -> shared_pt
                 vec3 scaledPos = rotatedPos + scale;
 
                 vec3 worldPos = scaledPos + wpos_scale.xyz;
+            #else
+                vec3 worldPos = _ModelMatrix * position;
+                vec4 outColor = color;
+            #endif
 
                 vec4 screenPos = _ViewProjectionMatrix * vec4(worldPos, 1.0);
 
                 gl_Position = screenPos;
                 procColor = outColor;
             }
-        );
+        )";
 
-        string_view psCode = SHADER_VERSION TOSTR(
+        const string_view PS = SHADER_VERSION R"(
             in vec4 procColor;
 
             layout(location = 0) out vec4 OutputColor;
 
+        #ifndef INSTANCED
+            layout(std140) uniform MaterialBlock
+            {
+                vec4 ColorMul;
+            };
+        #endif
+
             void main()
             {
+            #ifdef INSTANCED
                 OutputColor = procColor;
+            #else
+                OutputColor = procColor * ColorMul;
+            #endif
             }
-        );
-        
-        array<Shader::Uniform, 1> systemUniforms{
-            Shader::Uniform{"_ViewProjectionMatrix", 4, 4, 1, Shader::Uniform::Type::F32}};
-
-        array<string_view, 4> inputAttributes{"position", "color", "rotation", "wpos_scale"};
+        )";
 
-        auto shader = Shader::New(name, vsCode, psCode, nullptr, 0, inputAttributes.data(), (ui32)inputAttributes.size(), systemUniforms.data(), (ui32)systemUniforms.size());
+        const array<Shader::Uniform, 1> Uniforms{
+            Shader::Uniform{"ColorMul", 4, 1, 1, Shader::Uniform::Type::F32, {0, Instanced}}};
 
-        LoadedShaders.emplace(shader);
+        const array<Shader::Uniform, 2> SystemUniforms{
+            Shader::Uniform{"_ModelMatrix", 3, 4, 1, Shader::Uniform::Type::F32, {0, Instanced}},
+            Shader::Uniform{"_ViewProjectionMatrix", 4, 4, 1, Shader::Uniform::Type::F32}};
 
-        return shader;
+        const array<string_view, 4> InputAttributes{"position", "color", "rotation", "wpos_scale"};
+        const array<ShaderVariantCondition, 4> InputAttributesConditions{ShaderVariantCondition{}, ShaderVariantCondition{}, ShaderVariantCondition{Instanced}, ShaderVariantCondition{Instanced}};
     }
-    else if (name == "Colored3DVerticesProceduralInstanced")
+
+    namespace Colored3DVerticesProceduralInstanced
     {
-        string_view vsCode = SHADER_VERSION TOSTR(
+        const string_view VS = SHADER_VERSION TOSTR(
 			in int gl_VertexID;
 
             in vec4 rotation;
@@ -372,7 +383,7 @@ auto EngineCore::ShadersManager::FindShaderByName(string_view name) -> shared_pt
             }
         );
 
-        string_view psCode = SHADER_VERSION TOSTR(
+        const string_view PS = SHADER_VERSION TOSTR(
             in vec4 procColor;
 
             layout(location = 0) out vec4 OutputColor;
@@ -383,24 +394,19 @@ auto EngineCore::ShadersManager::FindShaderByName(string_view name) -> shared_pt
             }
         );
 
-		array<Shader::Uniform, 1> uniforms{
+        const array<Shader::Uniform, 1> Uniforms{
 			Shader::Uniform{"Transparency", 1, 1, 1, Shader::Uniform::Type::F32}};
-        
-        array<Shader::Uniform, 2> systemUniforms{
+
+        const array<Shader::Uniform, 2> SystemUniforms{
 			Shader::Uniform{"_CameraPosition", 3, 1, 1, Shader::Uniform::Type::F32},
             Shader::Uniform{"_ViewProjectionMatrix", 4, 4, 1, Shader::Uniform::Type::F32}};
 
-        array<string_view, 2> inputAttributes{"rotation", "wpos_scale"};
-
-        auto shader = Shader::New(name, vsCode, psCode, uniforms.data(), (ui32)uniforms.size(), inputAttributes.data(), (ui32)inputAttributes.size(), systemUniforms.data(), (ui32)systemUniforms.size());
-
-        LoadedShaders.emplace(shader);
-
-        return shader;
+        const array<string_view, 2> InputAttributes{"rotation", "wpos_scale"};
     }
-    else if (name == "Background")
+
+    namespace Background
     {
-        string_view vsCode = SHADER_VERSION TOSTR(
+        const string_view VS = SHADER_VERSION TOSTR(
             in int gl_VertexID;
 
             out vec3 vertexCoord;
@@ -441,7 +447,7 @@ auto EngineCore::ShadersManager::FindShaderByName(string_view name) -> shared_pt
             }
         );
 
-        string_view psCode = SHADER_VERSION TOSTR(
+        const string_view PS = SHADER_VERSION TOSTR(
             in vec3 vertexCoord;
 
             layout(location = 0) out vec4 OutputColor;
@@ -480,30 +486,30 @@ auto EngineCore::ShadersManager::FindShaderByName(string_view name) -> shared_pt
             }
         );
 
-        array<Shader::Uniform, 5> uniforms{
+        const array<Shader::Uniform, 5> Uniforms{
             Shader::Uniform{"PlaneSize", 4, 1, 1, Shader::Uniform::Type::F32},
             Shader::Uniform{"StripSizes", 4, 1, 1, Shader::Uniform::Type::F32},
             Shader::Uniform{"BackColor", 4, 1, 1, Shader::Uniform::Type::F32},
             Shader::Uniform{"ThickStripColor", 4, 1, 1, Shader::Uniform::Type::F32},
             Shader::Uniform{"ThinStripColor", 4, 1, 1, Shader::Uniform::Type::F32}};
 
-        array<Shader::Uniform, 2> systemUniforms{
+        const array<Shader::Uniform, 2> SystemUniforms{
             Shader::Uniform{"_ModelMatrix", 3, 4, 1, Shader::Uniform::Type::F32},
             Shader::Uniform{"_ViewProjectionMatrix", 4, 4, 1, Shader::Uniform::Type::F32}};
-
-        auto shader = Shader::New(name, vsCode, psCode, uniforms.data(), (ui32)uniforms.size(), nullptr, 0, systemUniforms.data(), (ui32)systemUniforms.size());
-
-        LoadedShaders.emplace(shader);
-
-        return shader;
     }
-    else if (name == "BackgroundTextured")
+
+    namespace BackgroundPlane
     {
-        string_view vsCode = SHADER_VERSION TOSTR(
+        constexpr ShaderVariantKey Textured = BuiltinShaderKeywords::BackgroundPlane.Key("TEXTURED");
+
+        // raw literals because TOSTR can't carry preprocessor directives
+        const string_view VS = SHADER_VERSION R"(
             in int gl_VertexID;
 
+        #ifdef TEXTURED
             out vec2 TexCoord;
             out vec3 VertexWorldPos;
+        #endif
 
             uniform vec2 PlaneSize;
 
@@ -513,40 +519,45 @@ auto EngineCore::ShadersManager::FindShaderByName(string_view name) -> shared_pt
             void main()
             {
                 vec4 position;
+                vec2 texCoord;
                 if (gl_VertexID == 0 || gl_VertexID == 5) /* bottom left */
                 {
                     position = vec4(-PlaneSize.x, -PlaneSize.y, 0, 1);
-                    TexCoord = vec2(0, 0);
+                    texCoord = vec2(0, 0);
                 }
                 else if (gl_VertexID == 1) /* top left */
                 {
                     position = vec4(-PlaneSize.x, PlaneSize.y, 0, 1);
-                    TexCoord = vec2(0, 1) * PlaneSize;
+                    texCoord = vec2(0, 1) * PlaneSize;
                 }
                 else if (gl_VertexID == 2 || gl_VertexID == 4) /* top right */
                 {
                     position = vec4(PlaneSize.x, PlaneSize.y, 0, 1);
-                    TexCoord = vec2(1, 1) * PlaneSize;
+                    texCoord = vec2(1, 1) * PlaneSize;
                 }
                 else /* if(gl_VertexID == 3) */ /* bottom right */
                 {
                     position = vec4(PlaneSize.x, -PlaneSize.y, 0, 1);
-                    TexCoord = vec2(1, 0) * PlaneSize;
+                    texCoord = vec2(1, 0) * PlaneSize;
                 }
 
                 vec3 worldPos = _ModelMatrix * position;
 
+            #ifdef TEXTURED
+                TexCoord = texCoord;
                 VertexWorldPos = worldPos;
+            #endif
 
                 vec4 screenPos = _ViewProjectionMatrix * vec4(worldPos, 1.0);
 
                 gl_Position = screenPos;
             }
-        );
+        )";
 
-        string_view psCode = SHADER_VERSION TOSTR(
+        const string_view PS = SHADER_VERSION R"(
             layout(location = 0) out vec4 OutputColor;
 
+        #ifdef TEXTURED
             uniform vec3 _CameraPosition;
             uniform sampler2D BackTextureThickThin;
             uniform sampler2D BackTextureThick;
@@ -555,9 +566,13 @@ auto EngineCore::ShadersManager::FindShaderByName(string_view name) -> shared_pt
 
             in vec2 TexCoord;
             in vec3 VertexWorldPos;
+        #else
+            uniform vec4 Color;
+        #endif
 
             void main()
             {
+            #ifdef TEXTURED
                 float dist = distance(VertexWorldPos, _CameraPosition);
 
                 vec4 finalColor;
@@ -579,93 +594,29 @@ auto EngineCore::ShadersManager::FindShaderByName(string_view name) -> shared_pt
                 }
 
                 OutputColor = finalColor;
+            #else
+                OutputColor = Color;
+            #endif
             }
-        );
+        )";
 
-        array<Shader::Uniform, 5> uniforms{
-            Shader::Uniform{"BackTextureThickThin", 1, 1, 1, Shader::Uniform::Type::Texture},
-            Shader::Uniform{"BackTextureThick", 1, 1, 1, Shader::Uniform::Type::Texture},
+        const array<Shader::Uniform, 6> Uniforms{
+            Shader::Uniform{"Color", 4, 1, 1, Shader::Uniform::Type::F32, {0, Textured}},
+            Shader::Uniform{"BackTextureThickThin", 1, 1, 1, Shader::Uniform::Type::Texture, {Textured}},
+            Shader::Uniform{"BackTextureThick", 1, 1, 1, Shader::Uniform::Type::Texture, {Textured}},
             Shader::Uniform{"PlaneSize", 2, 1, 1, Shader::Uniform::Type::F32},
-            Shader::Uniform{"ThinVisibility100Distance", 1, 1, 1, Shader::Uniform::Type::F32},
-            Shader::Uniform{"ThinVisibility0Distance", 1, 1, 1, Shader::Uniform::Type::F32}};
+            Shader::Uniform{"ThinVisibility100Distance", 1, 1, 1, Shader::Uniform::Type::F32, {Textured}},
+            Shader::Uniform{"ThinVisibility0Distance", 1, 1, 1, Shader::Uniform::Type::F32, {Textured}}};
 
-        array<Shader::Uniform, 3> systemUniforms{
+        const array<Shader::Uniform, 3> SystemUniforms{
             Shader::Uniform{"_ModelMatrix", 3, 4, 1, Shader::Uniform::Type::F32},
-            Shader::Uniform{"_CameraPosition", 3, 1, 1, Shader::Uniform::Type::F32},
+            Shader::Uniform{"_CameraPosition", 3, 1, 1, Shader::Uniform::Type::F32, {Textured}},
             Shader::Uniform{"_ViewProjectionMatrix", 4, 4, 1, Shader::Uniform::Type::F32}};
-
-        auto shader = Shader::New(name, vsCode, psCode, uniforms.data(), (ui32)uniforms.size(), nullptr, 0, systemUniforms.data(), (ui32)systemUniforms.size());
-
-        LoadedShaders.emplace(shader);
-
-        return shader;
     }
-	else if (name == "BackgroundColored")
-	{
-		string_view vsCode = SHADER_VERSION TOSTR(
-			in int gl_VertexID;
-
-			uniform vec2 PlaneSize;
-
-			uniform mat4x3 _ModelMatrix;
-			uniform mat4x4 _ViewProjectionMatrix;
-
-			void main()
-			{
-				vec4 position;
-				if (gl_VertexID == 0 || gl_VertexID == 5) /* bottom left */
-				{
-					position = vec4(-PlaneSize.x, -PlaneSize.y, 0, 1);
-				}
-				else if (gl_VertexID == 1) /* top left */
-				{
-					position = vec4(-PlaneSize.x, PlaneSize.y, 0, 1);
-				}
-				else if (gl_VertexID == 2 || gl_VertexID == 4) /* top right */
-				{
-					position = vec4(PlaneSize.x, PlaneSize.y, 0, 1);
-				}
-				else /* if(gl_VertexID == 3) */ /* bottom right */
-				{
-					position = vec4(PlaneSize.x, -PlaneSize.y, 0, 1);
-				}
 
-				vec3 worldPos = _ModelMatrix * position;
-
-				vec4 screenPos = _ViewProjectionMatrix * vec4(worldPos, 1.0);
-
-				gl_Position = screenPos;
-			}
-		);
-
-		string_view psCode = SHADER_VERSION TOSTR(
-			layout(location = 0) out vec4 OutputColor;
-
-			uniform vec4 Color;
-
-			void main()
-			{
-				OutputColor = Color;
-			}
-		);
-
-		array<Shader::Uniform, 2> uniforms{
-			Shader::Uniform{"Color", 4, 1, 1, Shader::Uniform::Type::F32},
-			Shader::Uniform{"PlaneSize", 2, 1, 1, Shader::Uniform::Type::F32} };
-
-		array<Shader::Uniform, 2> systemUniforms{
-			Shader::Uniform{"_ModelMatrix", 3, 4, 1, Shader::Uniform::Type::F32},
-			Shader::Uniform{"_ViewProjectionMatrix", 4, 4, 1, Shader::Uniform::Type::F32} };
-
-		auto shader = Shader::New(name, vsCode, psCode, uniforms.data(), (ui32)uniforms.size(), nullptr, 0, systemUniforms.data(), (ui32)systemUniforms.size());
-
-		LoadedShaders.emplace(shader);
-
-		return shader;
-	}
-    else if (name == "Line3D")
+    namespace Line3D
     {
-        string_view vsCode = SHADER_VERSION TOSTR(
+        const string_view VS = SHADER_VERSION TOSTR(
             in int gl_VertexID;
 
             in vec4 position;
@@ -689,7 +640,7 @@ auto EngineCore::ShadersManager::FindShaderByName(string_view name) -> shared_pt
             }
         );
 
-        string_view psCode = SHADER_VERSION TOSTR(
+        const string_view PS = SHADER_VERSION TOSTR(
             in vec2 procTexcoord;
 
             layout(location = 0) out vec4 OutputColor;
@@ -727,23 +678,18 @@ auto EngineCore::ShadersManager::FindShaderByName(string_view name) -> shared_pt
             }
         );
 
-        array<Shader::Uniform, 0> uniforms{};
+        const array<Shader::Uniform, 0> Uniforms{};
 
-        array<Shader::Uniform, 2> systemUniforms{
+        const array<Shader::Uniform, 2> SystemUniforms{
             Shader::Uniform{"_ModelMatrix", 3, 4, 1, Shader::Uniform::Type::F32},
             Shader::Uniform{"_ViewProjectionMatrix", 4, 4, 1, Shader::Uniform::Type::F32}};
 
-        array<string_view, 3> inputAttributes{"position", "texcoord", "scale"};
-
-        auto shader = Shader::New(name, vsCode, psCode, uniforms.data(), (ui32)uniforms.size(), inputAttributes.data(), (ui32)inputAttributes.size(), systemUniforms.data(), (ui32)systemUniforms.size());
-
-        LoadedShaders.emplace(shader);
-
-        return shader;
+        const array<string_view, 3> InputAttributes{"position", "texcoord", "scale"};
     }
-    else if (name == "OnlyDepthWrite")
+
+    namespace OnlyDepthWrite
     {
-        string_view vsCode = SHADER_VERSION TOSTR(
+        const string_view VS = SHADER_VERSION TOSTR(
             in vec4 position;
 
             uniform vec3 SidesScale;
@@ -760,27 +706,135 @@ auto EngineCore::ShadersManager::FindShaderByName(string_view name) -> shared_pt
             }
         );
 
-        string_view psCode = SHADER_VERSION TOSTR(
+        const string_view PS = SHADER_VERSION TOSTR(
             void main()
             {
             }
         );
 
-        array<Shader::Uniform, 1> uniforms{
+        const array<Shader::Uniform, 1> Uniforms{
             Shader::Uniform{"SidesScale", 3, 1, 1, Shader::Uniform::Type::F32}};
 
-        array<Shader::Uniform, 2> systemUniforms{
+        const array<Shader::Uniform, 2> SystemUniforms{
             Shader::Uniform{"_ModelMatrix", 3, 4, 1, Shader::Uniform::Type::F32},
             Shader::Uniform{"_ViewProjectionMatrix", 4, 4, 1, Shader::Uniform::Type::F32}};
 
-        array<string_view, 1> inputAttributes{"position"};
+        const array<string_view, 1> InputAttributes{"position"};
+    }
 
-        auto shader = Shader::New(name, vsCode, psCode, uniforms.data(), (ui32)uniforms.size(), inputAttributes.data(), (ui32)inputAttributes.size(), systemUniforms.data(), (ui32)systemUniforms.size());
+    const ShaderPackage::ShaderDescription Descriptions[] =
+    {
+        {"Color", Color::VS, Color::PS, Color::Uniforms, {}, {}},
+        {"ColoredVertices", ColoredVertices::VS, ColoredVertices::PS, ColoredVertices::Uniforms, ColoredVertices::InputAttributes, {}},
+        {"Colored3DVertices", Colored3DVertices::VS, Colored3DVertices::PS, Colored3DVertices::Uniforms, Colored3DVertices::InputAttributes, Colored3DVertices::SystemUniforms, BuiltinShaderKeywords::Colored3DVertices.Names(), Colored3DVertices::InputAttributesConditions},
+        {"Colored3DVerticesProceduralInstanced", Colored3DVerticesProceduralInstanced::VS, Colored3DVerticesProceduralInstanced::PS, Colored3DVerticesProceduralInstanced::Uniforms, Colored3DVerticesProceduralInstanced::InputAttributes, Colored3DVerticesProceduralInstanced::SystemUniforms},
+        {"Background", Background::VS, Background::PS, Background::Uniforms, {}, Background::SystemUniforms},
+        {"BackgroundPlane", BackgroundPlane::VS, BackgroundPlane::PS, BackgroundPlane::Uniforms, {}, BackgroundPlane::SystemUniforms, BuiltinShaderKeywords::BackgroundPlane.Names()},
+        {"Line3D", Line3D::VS, Line3D::PS, Line3D::Uniforms, Line3D::InputAttributes, Line3D::SystemUniforms},
+        {"OnlyDepthWrite", OnlyDepthWrite::VS, OnlyDepthWrite::PS, OnlyDepthWrite::Uniforms, OnlyDepthWrite::InputAttributes, OnlyDepthWrite::SystemUniforms}
+    };
+}
 
-        LoadedShaders.emplace(shader);
+namespace
+{
+    shared_ptr<Shader> CreateFromPackage(const ShaderPackage::Reader &package, const ShaderPackage::ShaderRecord &record)
+    {
+        auto toUniforms = [&package](span<const ShaderPackage::UniformRecord> records)
+        {
+            vector<Shader::Uniform> uniforms;
+            uniforms.reserve(records.size());
+            for (const auto &uniform : records)
+            {
+                uniforms.push_back(package.Uniform(uniform));
+            }
+            return uniforms;
+        };
+
+        vector<Shader::Uniform> uniforms = toUniforms(package.Uniforms(record));
+        vector<Shader::Uniform> systemUniforms = toUniforms(package.SystemUniforms(record));
+
+        vector<string_view> inputAttributes;
+        vector<ShaderVariantCondition> inputAttributesConditions;
+        inputAttributes.reserve(record.inputAttributesCount);
+        inputAttributesConditions.reserve(record.inputAttributesCount);
+        for (const auto &attribute : package.InputAttributes(record))
+        {
+            inputAttributes.push_back(package.String(attribute.name));
+            inputAttributesConditions.push_back(attribute.condition);
+        }
+
+        vector<string_view> keywords;
+        keywords.reserve(record.keywordsCount);
+        for (const auto &keyword : package.Keywords(record))
+        {
+            keywords.push_back(package.String(keyword));
+        }
+
+        return Shader::New(package.String(record.name), package.String(record.vsCode), package.String(record.psCode), uniforms.data(), (ui32)uniforms.size(), inputAttributes.data(), (ui32)inputAttributes.size(), systemUniforms.data(), (ui32)systemUniforms.size(), keywords.data(), (ui32)keywords.size(), inputAttributesConditions.data());
+    }
+
+    shared_ptr<Shader> CreateFromDescription(const ShaderPackage::ShaderDescription &description)
+    {
+        return Shader::New(description.name, description.vsCode, description.psCode, description.uniforms.data(), (ui32)description.uniforms.size(), description.inputAttributes.data(), (ui32)description.inputAttributes.size(), description.systemUniforms.data(), (ui32)description.systemUniforms.size(), description.keywords.data(), (ui32)description.keywords.size(), description.inputAttributesConditions.empty() ? nullptr : description.inputAttributesConditions.data());
+    }
+}
+
+bool ShadersManager::LoadPackage(const FilePath &path)
+{
+    auto package = ShaderPackage::Reader::Open(path);
+    if (package == nullptr)
+    {
+        return false;
+    }
+    SENDLOG(Info, "Loaded shader package " PTHSTR " with %u shaders\n", path.PlatformPath().data(), (ui32)package->Index().size());
+    Packages.push_back(move(package));
+    return true;
+}
+
+bool ShadersManager::SaveBuiltinPackage(const FilePath &path)
+{
+    ShaderPackage::Builder builder;
+    for (const auto &description : BuiltinShaders::Descriptions)
+    {
+        builder.Add(description);
+    }
+    return builder.Save(path);
+}
+
+auto ShadersManager::BuiltinDescriptions() -> span<const ShaderPackage::ShaderDescription>
+{
+    return BuiltinShaders::Descriptions;
+}
+
+auto ShadersManager::FindShaderHandle(string_view name) -> ShaderHandle
+{
+    return FindShaderByName(name);
+}
 
-        return shader;
+auto ShadersManager::FindShaderByName(string_view name) -> shared_ptr<Shader>
+{
+    auto searchResult = LoadedShaders.find(name);
+    if (searchResult != LoadedShaders.end())
+    {
+        return searchResult->second;
+    }
+
+    for (auto it = Packages.rbegin(); it != Packages.rend(); ++it)
+    {
+        if (const auto *record = (*it)->Find(name))
+        {
+            return Register(CreateFromPackage(**it, *record));
+        }
+    }
+
+    for (const auto &description : BuiltinShaders::Descriptions)
+    {
+        if (description.name == name)
+        {
+            return Register(CreateFromDescription(description));
+        }
     }
 
+    SENDLOG(Error, "Shader %*s wasn't found\n", SVIEWARG(name));
     return nullptr;
 }
\ No newline at end of file
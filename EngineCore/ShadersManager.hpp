@@ -1,11 +1,25 @@
 #pragma once
 
-namespace EngineCore
+#include "ShaderPackage.hpp"
+
+// keywords of the built-in shaders, use them to get variant keys, bind the keys to constexpr so a misspelled keyword fails to compile, for example
+// constexpr ShaderVariantKey instancedKey = BuiltinShaderKeywords::Colored3DVertices.Key("INSTANCED");
+// Shader::Variant(shader, instancedKey)
+namespace EngineCore::BuiltinShaderKeywords
 {
-	class Shader;
+	inline constexpr ShaderKeywordTable Colored3DVertices{"INSTANCED"};
+	inline constexpr ShaderKeywordTable BackgroundPlane{"TEXTURED"};
 }
 
 namespace EngineCore::ShadersManager
 {
+	// shaders from loaded packages take precedence over the built-in ones and a later package over an earlier one, so they can be changed without recompiling
+	// shaders that have already been created keep using the package they were created from
+	bool LoadPackage(const FilePath &path);
+	bool SaveBuiltinPackage(const FilePath &path); // writes the built-in shaders as a package to be used as a starting point
+	span<const ShaderPackage::ShaderDescription> BuiltinDescriptions();
+
+	// shaders are created on the first request and kept for the application's lifetime, lookups are a single hash table probe
 	shared_ptr<Shader> FindShaderByName(string_view name);
+	ShaderHandle FindShaderHandle(string_view name);
 }
\ No newline at end of file
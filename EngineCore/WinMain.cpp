@@ -10,6 +10,9 @@
 #include <OpenGLRenderer.hpp>
 #include "KeyController.hpp"
 #include "RecordingKeyController.hpp"
+#include "HeadlessBenchmark.hpp"
+#include "HeadlessChecks.hpp"
+#include "ShadersManager.hpp"
 
 using namespace EngineCore;
 
@@ -42,8 +45,9 @@ namespace
 	StdLib::Logger<void, false>::ListenerHandle LogListener{};
 	StdLib::Logger<void, false>::ListenerHandle FileLogListener{};
 	File LogFile{};
-	vector<ControlAction> AllReceivedControlActions{};
-	IKeyController::ListenerHandle ControlActionRecordingListener{};
+
+	uiw ControlsQueueReportedDrops{};
+	uiw ControlsQueueReportedHighWatermark{};
 
 	ui32 SceneRestartedCounter{};
 	ui32 UpTimeDeltaCounter{}, DownTimeDeltaCounter{};
@@ -169,15 +173,6 @@ int CALLBACK WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
 
 	LogListener = Application::GetLogger().OnMessage(LogRecipient);
 
-	auto recordingController = RecordingKeyController::New(KeyController::New());
-	ControlActionRecordingListener = recordingController->OnRecordingControlAction(
-		[](const ControlAction &action) -> bool
-		{
-			AllReceivedControlActions.push_back(action);
-			return false;
-		});
-	Application::SetKeyController(recordingController);
-
 	LogFile = File(FilePath::FromChar("log.txt"), FileOpenMode::CreateAlways, FileProcModes::Write);
 	if (LogFile.IsOpen())
 	{
@@ -186,6 +181,34 @@ int CALLBACK WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
 
 	SENDLOG(Info, "Log started\n");
 
+	// the package is optional, it overrides the built-in shaders
+	if (!ShadersManager::LoadPackage(FilePath::FromChar("shaders.shpk")))
+	{
+		SENDLOG(Info, "Using built-in shaders\n");
+	}
+
+	// must be checked before the recording starts, the benchmark may replay the previously recorded controls.log
+	if (auto benchmarkSettings = HeadlessBenchmark::ParseCommandLine(__argc, __argv))
+	{
+		bool isSucceeded = HeadlessBenchmark::Run(*benchmarkSettings);
+		Application::Destroy();
+		return isSucceeded ? 0 : 1;
+	}
+
+	if (HeadlessChecks::IsRequested(__argc, __argv))
+	{
+		bool isSucceeded = HeadlessChecks::Run();
+		Application::Destroy();
+		return isSucceeded ? 0 : 1;
+	}
+
+	auto recordingController = RecordingKeyController::New(KeyController::New());
+	if (!recordingController->StartRecording(FilePath::FromChar("controls.log")))
+	{
+		SENDLOG(Warning, "Controls won't be recorded\n");
+	}
+	Application::SetKeyController(recordingController);
+
 	if (CreateApplicationSubsystems() == false)
 	{
 		ShutdownApp();
@@ -251,6 +274,13 @@ bool CreateApplicationSubsystems()
 
 	static WindowData windowData;
 	windowData.hwnd = *systemWindow;
+	// coalesced moves reach controls.log already merged, so the recording is lossy, -coalesce_moves enables it for high polling rate devices
+	bool isCoalescingMoves = std::any_of(__argv + 1, __argv + __argc, [](const char *arg) { return string_view(arg) == "-coalesce_moves"; });
+	windowData.controlsQueue.CoalesceMoves(isCoalescingMoves);
+	if (isCoalescingMoves)
+	{
+		SENDLOG(Info, "Mouse and touch moves are coalesced, controls.log won't have every move\n");
+	}
 	SetWindowLongPtrA(*systemWindow, GWLP_USERDATA, (LONG_PTR)& windowData);
 
 	auto hid = make_unique<HIDInput>();
@@ -296,7 +326,7 @@ bool CreateApplicationSubsystems()
 	Application::GetMainCamera()->RenderTarget(renderTarget);
 	Application::GetMainCamera()->Position(Vector3(5, 50, -75));
 
-	if (SceneToDraw::Create() == false)
+	if (SceneToDraw::Create(false) == false)
 	{
 		SENDLOG(Critical, "Failed to create the scene\n");
 		return false;
@@ -350,8 +380,22 @@ void MessageLoop()
 			WindowData *windowData = (WindowData *)GetWindowLongPtrA(Application::GetMainWindow().hwnd, GWLP_USERDATA);
 			if (windowData != nullptr)
 			{
-				Application::GetKeyController().Dispatch(windowData->controlsQueue.Enumerate());
+				for (auto actions : windowData->controlsQueue.Spans())
+				{
+					Application::GetKeyController().Dispatch(actions);
+				}
 				windowData->controlsQueue.clear();
+
+				if (auto drops = windowData->controlsQueue.DroppedCount(); drops != ControlsQueueReportedDrops)
+				{
+					SENDLOG(Warning, "Controls queue overflowed, %u actions dropped since the last frame, %u in total\n", (ui32)(drops - ControlsQueueReportedDrops), (ui32)drops);
+					ControlsQueueReportedDrops = drops;
+				}
+				if (auto highWatermark = windowData->controlsQueue.HighWatermark(); highWatermark != ControlsQueueReportedHighWatermark)
+				{
+					SENDLOG(Info, "Controls queue high watermark has grown to %u of %u\n", (ui32)highWatermark, (ui32)windowData->controlsQueue.Capacity());
+					ControlsQueueReportedHighWatermark = highWatermark;
+				}
 			}
 			else
 			{
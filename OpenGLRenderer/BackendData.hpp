@@ -3,16 +3,43 @@
 #include <System.hpp>
 #include <Texture.hpp>
 #include <RendererArray.hpp>
+#include <Shader.hpp>
 
 namespace OGLRenderer
 {
+    // uniform blocks filled by the backend, shaders opt in by declaring them as layout(std140) uniform <Name>
+    // uniforms that are members of a block aren't set with glUniform* calls
+    namespace UniformBlocks
+    {
+        constexpr GLuint CameraBinding = 0, MaterialBinding = 1;
+        constexpr const char *CameraName = "CameraBlock", *MaterialName = "MaterialBlock";
+
+        // uploaded only when the camera changes, the members are declared in this order
+        // mat4x4 _ViewProjectionMatrix, mat4x4 _ProjectionMatrix, mat4x3 _ViewMatrix, vec3 _CameraPosition, vec3 _CameraForwardVector, vec3 _CameraRightVector, vec3 _CameraUpVector
+        struct CameraData
+        {
+            array<f32, 16> viewProjMatrix;
+            array<f32, 16> projMatrix;
+            array<f32, 16> viewMatrix; // every column is padded to vec4
+            array<f32, 4> position, forwardVector, rightVector, upVector;
+        };
+        static_assert(sizeof(CameraData) == 256);
+
+        // MaterialBlock has all non-texture uniforms of the shader as its members in their declaration order
+        // it's uploaded only when the material is dirty, so switching materials is a single glBindBufferRange
+        [[nodiscard]] ui32 Std140Align(ui32 offset, const EngineCore::Shader::Uniform &uniform);
+        [[nodiscard]] ui32 Std140Size(const EngineCore::Shader::Uniform &uniform);
+        void Std140Write(const EngineCore::Shader::Uniform &uniform, const ui8 *packedData, ui8 *target); // packedData is laid out the way glUniform* expects it
+    }
+
     struct RendererBackendDataBase
     {
+        enum class BackendDataType { RenderTarget, Texture, TextureSampler, Shader, Material, PipelineState, Array };
+
         void **backendDataPointer = 0;
+        BackendDataType type{}; // set by the renderer when the data is allocated
 
         virtual ~RendererBackendDataBase() = default;
-
-        enum class BackendDataType { RenderTarget, Texture, TextureSampler, Shader, Material, PipelineState, Array };
     };
 
 	struct RenderTargetBackendData : public RendererBackendDataBase
@@ -73,14 +100,31 @@ namespace OGLRenderer
 
 		GLuint program = 0;
         unique_ptr<OGLUniform[]> oglUniforms{};
-        unique_ptr<OGLUniform[]> systemOglUniforms{};
+        array<OGLUniform, (uiw)Shader::SystemUniformSlot::_size> systemOglUniforms{}; // indexed by the slot, setFuncAddress is 0 if the shader doesn't have the uniform
         unique_ptr<GLint[]> attributeLocations{};
+        ui32 materialBlockSize = 0; // 0 if the shader doesn't declare UniformBlocks::MaterialName
+
+        // the compilation that has been started, but not finished yet, see OpenGLRendererProxy::BeginShaderCompilation
+        GLuint pendingProgram = 0;
+        array<GLuint, 2> pendingShaders{};
+        ui64 binaryKey = 0;
+        bool isPendingFromBinary = false;
 
 		virtual ~ShaderBackendData()
 		{
+            DeletePending();
 			glDeleteProgram(program);
 		}
 
+        void DeletePending()
+        {
+            glDeleteProgram(pendingProgram);
+            glDeleteShader(pendingShaders[0]);
+            glDeleteShader(pendingShaders[1]);
+            pendingProgram = 0;
+            pendingShaders = {};
+        }
+
         static RendererBackendDataBase::BackendDataType Type() { return RendererBackendDataBase::BackendDataType::Shader; }
 	};
 
@@ -94,14 +138,35 @@ namespace OGLRenderer
         static_assert(std::is_trivially_copyable_v<TextureUniform>);
 
         unique_ptr<ui8[]> uniforms{};
+        GLuint uniformBuffer = 0; // std140 copy of the non-texture uniforms, only if the shader has UniformBlocks::MaterialName
+        ui32 uniformBufferSize = 0;
 
-        virtual ~MaterialBackendData() = default;
+        virtual ~MaterialBackendData()
+        {
+            glDeleteBuffers(1, &uniformBuffer);
+        }
 
         static RendererBackendDataBase::BackendDataType Type() { return RendererBackendDataBase::BackendDataType::Material; }
 	};
 
     struct PipelineStateBackendData : public RendererBackendDataBase
     {
+        // the pipeline's input attributes matched against a shader program's attributes, resolved once per program
+        struct ResolvedAttribute
+        {
+            GLuint location;
+            ui8 vertexArrayNumber;
+            GLint componentsCount;
+            GLenum componentType;
+            uiw offset;
+            GLuint divisor;
+        };
+
+        const EngineCore::Shader *resolvedShader = nullptr;
+        GLuint resolvedProgram = 0;
+        vector<ResolvedAttribute> resolvedAttributes{};
+        ui64 layoutId = 0; // unique for every resolve, a part of the vertex array cache key
+
         virtual ~PipelineStateBackendData() = default;
 
         static RendererBackendDataBase::BackendDataType Type() { return RendererBackendDataBase::BackendDataType::PipelineState; }
@@ -109,12 +174,40 @@ namespace OGLRenderer
 
     struct ArrayBackendData : public RendererBackendDataBase
     {
-        EngineCore::RendererArray::BufferOwnedData data{};
+        // FrequentFull vertex arrays are streamed through a persistently mapped ring of regions, every lock moves to the next region
+        // and waits for its fence, so writes go straight into GPU-visible memory without a shadow copy and without implicit syncs
+        static constexpr ui32 StreamingRegionsCount = 3;
+
+        const EngineCore::RendererArray *array = nullptr;
+        EngineCore::RendererArray::BufferOwnedData data{}; // the shadow copy, kept only for readable arrays
+        ui8 *staging = nullptr; // holds the locked region of arrays without a shadow copy while they're locked
         GLuint oglBuffer = 0;
+        ui64 bufferId = 0; // unlike GL names ids are never reused, a part of the vertex array cache key
         ui32 lockStart = 0, lockEnd = 0;
+        ui8 *streamingMemory = nullptr; // nullptr if the array isn't streamed
+        ui32 streamingRegionSize = 0;
+        ui32 streamingRegion = 0; // the region the GPU reads from
+        array<GLsync, StreamingRegionsCount> streamingFences{};
+
+        ui32 StreamingRegionOffset() const
+        {
+            return streamingRegion * streamingRegionSize;
+        }
+
+        void ReleaseStreaming()
+        {
+            for (GLsync &fence : streamingFences)
+            {
+                glDeleteSync(fence); // 0 is silently ignored
+                fence = 0;
+            }
+            streamingMemory = nullptr; // unmapped when the buffer is deleted
+            streamingRegionSize = streamingRegion = 0;
+        }
 
         virtual ~ArrayBackendData()
         {
+            ReleaseStreaming();
             glDeleteBuffers(1, &oglBuffer);
         }
 
@@ -7,6 +7,8 @@
 #ifdef WINPLATFORM
 #include <GL/wglew.h>
 #pragma comment(lib, "Opengl32.lib")
+#else
+#include <EGL/egl.h>
 #endif
 
 #ifdef _WIN64
@@ -0,0 +1,150 @@
+#include "BasicHeader.hpp"
+#include "GLStateCache.hpp"
+
+using namespace EngineCore;
+using namespace OGLRenderer;
+
+bool GLStateCache::BlendState::operator == (const BlendState &other) const
+{
+    if (isEnabled != other.isEnabled)
+    {
+        return false;
+    }
+    if (!isEnabled)
+    {
+        return true; // factors don't matter, they'll be set when blending is enabled again
+    }
+    return sourceColorFactor == other.sourceColorFactor && targetColorFactor == other.targetColorFactor &&
+        sourceAlphaFactor == other.sourceAlphaFactor && targetAlphaFactor == other.targetAlphaFactor &&
+        colorCombineMode == other.colorCombineMode && alphaCombineMode == other.alphaCombineMode;
+}
+
+bool GLStateCache::BlendState::operator != (const BlendState &other) const
+{
+    return !operator == (other);
+}
+
+template <typename T> bool GLStateCache::Update(optional<T> &current, const T &value)
+{
+    if (current && *current == value)
+    {
+        ++_counters.skippedCalls;
+        return false;
+    }
+    current = value;
+    ++_counters.issuedCalls;
+    return true;
+}
+
+void GLStateCache::PolygonMode(GLenum mode)
+{
+    if (Update(_polygonMode, mode))
+    {
+        glPolygonMode(GL_FRONT_AND_BACK, mode);
+    }
+}
+
+void GLStateCache::CullFace(bool isEnabled, GLenum face)
+{
+    if (_cull && _cull->isEnabled == isEnabled && (!isEnabled || _cull->face == face))
+    {
+        ++_counters.skippedCalls;
+        return;
+    }
+
+    if (!_cull || _cull->isEnabled != isEnabled)
+    {
+        isEnabled ? glEnable(GL_CULL_FACE) : glDisable(GL_CULL_FACE);
+        ++_counters.issuedCalls;
+    }
+    if (isEnabled && (!_cull || _cull->face != face))
+    {
+        glCullFace(face);
+        ++_counters.issuedCalls;
+    }
+
+    // the face is kept while culling is disabled, glCullFace doesn't have to be repeated if it's enabled with the same face
+    // if the state was unknown, the face wasn't issued, GL_NONE matches no face, so the first enable sets it
+    GLenum currentFace = isEnabled ? face : (_cull ? _cull->face : GL_NONE);
+    _cull = CullState{isEnabled, currentFace};
+}
+
+void GLStateCache::DepthTest(bool isEnabled)
+{
+    if (Update(_isDepthTestEnabled, isEnabled))
+    {
+        isEnabled ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
+    }
+}
+
+void GLStateCache::DepthFunc(GLenum func)
+{
+    if (Update(_depthFunc, func))
+    {
+        glDepthFunc(func);
+    }
+}
+
+void GLStateCache::DepthMask(bool isEnabled)
+{
+    if (Update(_isDepthWriteEnabled, isEnabled))
+    {
+        glDepthMask(isEnabled ? GL_TRUE : GL_FALSE);
+    }
+}
+
+void GLStateCache::FrontFace(GLenum mode)
+{
+    if (Update(_frontFace, mode))
+    {
+        glFrontFace(mode);
+    }
+}
+
+void GLStateCache::Blend(ui32 renderTargetIndex, const BlendState &state)
+{
+    ASSUME(renderTargetIndex < RenderTargetsLimit);
+
+    auto &current = _blend[renderTargetIndex];
+    if (current && *current == state)
+    {
+        ++_counters.skippedCalls;
+        return;
+    }
+
+    if (!current || current->isEnabled != state.isEnabled)
+    {
+        state.isEnabled ? glEnablei(GL_BLEND, renderTargetIndex) : glDisablei(GL_BLEND, renderTargetIndex);
+        ++_counters.issuedCalls;
+    }
+
+    // factors of disabled blending aren't tracked, so they're always set when it's enabled
+    if (state.isEnabled)
+    {
+        glBlendFuncSeparatei(renderTargetIndex, state.sourceColorFactor, state.targetColorFactor, state.sourceAlphaFactor, state.targetAlphaFactor);
+        glBlendEquationSeparatei(renderTargetIndex, state.colorCombineMode, state.alphaCombineMode);
+        _counters.issuedCalls += 2;
+    }
+    current = state;
+}
+
+void GLStateCache::Invalidate()
+{
+    _polygonMode = nullopt;
+    _cull = nullopt;
+    _isDepthTestEnabled = nullopt;
+    _depthFunc = nullopt;
+    _isDepthWriteEnabled = nullopt;
+    _frontFace = nullopt;
+    _blend = {};
+}
+
+auto GLStateCache::CurrentCounters() const -> const Counters &
+{
+    return _counters;
+}
+
+void GLStateCache::ResetCounters()
+{
+    _counters = {};
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+namespace OGLRenderer
+{
+    // shadow copy of the fixed function state, a GL call is issued only if the value differs from the one that has been set last
+    // the state is unknown after creation and after Invalidate, so the first call of each kind always goes through
+    class GLStateCache
+    {
+    public:
+        struct BlendState
+        {
+            bool isEnabled;
+            GLenum sourceColorFactor, targetColorFactor, sourceAlphaFactor, targetAlphaFactor;
+            GLenum colorCombineMode, alphaCombineMode;
+
+            bool operator == (const BlendState &other) const;
+            bool operator != (const BlendState &other) const;
+        };
+
+        struct Counters
+        {
+            ui32 issuedCalls = 0;
+            ui32 skippedCalls = 0;
+        };
+
+    private:
+        struct CullState
+        {
+            bool isEnabled;
+            GLenum face;
+        };
+
+        optional<GLenum> _polygonMode{};
+        optional<CullState> _cull{};
+        optional<bool> _isDepthTestEnabled{};
+        optional<GLenum> _depthFunc{};
+        optional<bool> _isDepthWriteEnabled{};
+        optional<GLenum> _frontFace{};
+        array<optional<BlendState>, RenderTargetsLimit> _blend{};
+        Counters _counters{};
+
+    public:
+        void PolygonMode(GLenum mode);
+        void CullFace(bool isEnabled, GLenum face); // face is ignored if culling is disabled
+        void DepthTest(bool isEnabled);
+        void DepthFunc(GLenum func);
+        void DepthMask(bool isEnabled);
+        void FrontFace(GLenum mode);
+        void Blend(ui32 renderTargetIndex, const BlendState &state);
+
+        void Invalidate(); // call after the state has been changed bypassing the cache
+
+        [[nodiscard]] const Counters &CurrentCounters() const;
+        void ResetCounters();
+
+    private:
+        // returns true if the call must be issued
+        template <typename T> bool Update(optional<T> &current, const T &value);
+    };
+}
\ No newline at end of file
@@ -10,6 +10,50 @@
 using namespace EngineCore;
 using namespace OGLRenderer;
 
+ui32 UniformBlocks::Std140Align(ui32 offset, const Shader::Uniform &uniform)
+{
+    ui32 alignment = 16;
+    if (uniform.elementHeight == 1 && uniform.elementsCount == 1 && uniform.elementWidth < 3)
+    {
+        alignment = 4 * uniform.elementWidth;
+    }
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+ui32 UniformBlocks::Std140Size(const Shader::Uniform &uniform)
+{
+    assert(uniform.type != Shader::Uniform::Type::Texture);
+
+    // matrices are arrays of columns, elementHeight is the number of columns, every array element is padded to vec4
+    if (uniform.elementHeight > 1)
+    {
+        return 16 * uniform.elementHeight * uniform.elementsCount;
+    }
+    if (uniform.elementsCount > 1)
+    {
+        return 16 * uniform.elementsCount;
+    }
+    return 4 * uniform.elementWidth;
+}
+
+void UniformBlocks::Std140Write(const Shader::Uniform &uniform, const ui8 *packedData, ui8 *target)
+{
+    assert(uniform.type != Shader::Uniform::Type::Texture);
+
+    ui32 vectorSize = 4 * uniform.elementWidth;
+    ui32 vectorsCount = uniform.elementHeight * uniform.elementsCount;
+    if (vectorsCount == 1)
+    {
+        MemOps::Copy(target, packedData, vectorSize);
+        return;
+    }
+
+    for (ui32 index = 0; index < vectorsCount; ++index)
+    {
+        MemOps::Copy(target + index * 16, packedData + index * vectorSize, vectorSize);
+    }
+}
+
 bool OpenGLRendererProxy::CheckMaterialBackendData(const Material &material)
 {
 	if (RendererBackendData(material) == nullptr)
@@ -51,7 +95,7 @@ bool OpenGLRendererProxy::CheckMaterialBackendData(const Material &material)
 	{
 		uiw uniformsSizeOf = 0;
 
-		for (const auto &uniform : material.Shader()->Uniforms())
+		for (const auto &uniform : material.BoundShader()->Uniforms())
 		{
 			uniformsSizeOf += getUniformSizeOf(uniform);
 		}
@@ -64,7 +108,7 @@ bool OpenGLRendererProxy::CheckMaterialBackendData(const Material &material)
 	for (ui32 uniformIndex = 0; uniformIndex < uniformsCount; ++uniformIndex)
 	{
 		const auto &matUniform = material.CurrentUniforms()[uniformIndex];
-		const auto &shaderUniforms = material.Shader()->Uniforms();
+		const auto &shaderUniforms = material.BoundShader()->Uniforms();
 		const auto &shaderUniform = shaderUniforms[uniformIndex];
 
         switch (shaderUniform.type)
@@ -161,5 +205,34 @@ bool OpenGLRendererProxy::CheckMaterialBackendData(const Material &material)
 		uniformsMemory += getUniformSizeOf(shaderUniform);
 	}
 
+    auto *shaderBackendData = RendererBackendData<ShaderBackendData>(*material.BoundShader());
+    if (shaderBackendData && shaderBackendData->materialBlockSize)
+    {
+        vector<ui8> block(shaderBackendData->materialBlockSize);
+        const ui8 *packedMemory = backendData.uniforms.get();
+        ui32 blockOffset = 0;
+
+        for (const auto &shaderUniform : material.BoundShader()->Uniforms())
+        {
+            if (shaderUniform.type != Shader::Uniform::Type::Texture)
+            {
+                blockOffset = UniformBlocks::Std140Align(blockOffset, shaderUniform);
+                UniformBlocks::Std140Write(shaderUniform, packedMemory, block.data() + blockOffset);
+                blockOffset += UniformBlocks::Std140Size(shaderUniform);
+            }
+            packedMemory += getUniformSizeOf(shaderUniform);
+        }
+        assert(blockOffset <= block.size());
+
+        if (backendData.uniformBuffer == 0)
+        {
+            glGenBuffers(1, &backendData.uniformBuffer);
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, backendData.uniformBuffer);
+        glBufferData(GL_UNIFORM_BUFFER, block.size(), block.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        backendData.uniformBufferSize = (ui32)block.size();
+    }
+
     return true;
 }
\ No newline at end of file
@@ -0,0 +1,269 @@
+#include "BasicHeader.hpp"
+
+#ifndef WINPLATFORM
+
+#include "OpenGLContextEGL.hpp"
+#include <Application.hpp>
+#include <Logger.hpp>
+#include <EGL/eglext.h>
+
+namespace
+{
+	struct ColorChannelSizes
+	{
+		EGLint red, green, blue, alpha;
+	};
+
+	// channel order doesn't matter for the default framebuffer's config, float formats would need EGL_EXT_pixel_format_float and aren't supported
+	optional<ColorChannelSizes> ColorChannelSizesFor(EngineCore::TextureDataFormat colorFormat)
+	{
+		using EngineCore::TextureDataFormat;
+
+		switch (colorFormat)
+		{
+		case TextureDataFormat::R8G8B8A8:
+		case TextureDataFormat::B8G8R8A8:
+			return ColorChannelSizes{8, 8, 8, 8};
+		case TextureDataFormat::R8G8B8:
+		case TextureDataFormat::B8G8R8:
+		case TextureDataFormat::R8G8B8X8:
+		case TextureDataFormat::B8G8R8X8:
+			return ColorChannelSizes{8, 8, 8, 0};
+		case TextureDataFormat::R4G4B4A4:
+		case TextureDataFormat::B4G4R4A4:
+			return ColorChannelSizes{4, 4, 4, 4};
+		case TextureDataFormat::R5G6B5:
+		case TextureDataFormat::B5G6R5:
+			return ColorChannelSizes{5, 6, 5, 0};
+		default:
+			return nullopt;
+		}
+	}
+}
+
+class OpenGLContextEGLImpl final : public OGLRenderer::OpenGLContextEGL
+{
+	EGLDisplay _display = EGL_NO_DISPLAY;
+	EGLSurface _surface = EGL_NO_SURFACE;
+	EGLContext _context = EGL_NO_CONTEXT;
+
+	virtual void MakeCurrent() override
+	{
+		eglMakeCurrent(_display, _surface, _surface, _context);
+	}
+
+	virtual void SwapBuffers() override
+	{
+		if (_surface != EGL_NO_SURFACE)
+		{
+			eglSwapBuffers(_display, _surface);
+		}
+		else
+		{
+			glFlush();
+		}
+	}
+
+	virtual void *ContextPointer() override
+	{
+		return _context;
+	}
+
+	virtual EGLDisplay Display() const override
+	{
+		return _display;
+	}
+
+	virtual EGLContext Context() const override
+	{
+		return _context;
+	}
+
+public:
+	virtual ~OpenGLContextEGLImpl()
+	{
+		if (_display == EGL_NO_DISPLAY)
+		{
+			return;
+		}
+
+		eglMakeCurrent(_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+		if (_context != EGL_NO_CONTEXT)
+		{
+			eglDestroyContext(_display, _context);
+		}
+		if (_surface != EGL_NO_SURFACE)
+		{
+			eglDestroySurface(_display, _surface);
+		}
+		eglTerminate(_display);
+
+		SENDLOG(Info, "OpenGL EGL context's destroyed\n");
+	}
+
+	OpenGLContextEGLImpl()
+	{}
+
+	bool Create(EngineCore::TextureDataFormat colorFormat, ui32 depth, ui32 stencil)
+	{
+		assert(_display == EGL_NO_DISPLAY);
+
+		auto channelSizes = ColorChannelSizesFor(colorFormat);
+		if (channelSizes == nullopt)
+		{
+			SENDLOG(Critical, "EGL OpenGL context init failed, color format %u isn't supported for the default framebuffer\n", (ui32)colorFormat);
+			return false;
+		}
+
+		// the surfaceless platform doesn't need a display server, the default display is the fallback for drivers that don't have it
+		auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+		if (getPlatformDisplay != nullptr)
+		{
+			_display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+		}
+		if (_display == EGL_NO_DISPLAY)
+		{
+			_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		}
+		if (_display == EGL_NO_DISPLAY)
+		{
+			SENDLOG(Critical, "EGL OpenGL context init failed, no display\n");
+			return false;
+		}
+
+		EGLint major = 0, minor = 0;
+		if (eglInitialize(_display, &major, &minor) == EGL_FALSE)
+		{
+			SENDLOG(Critical, "EGL OpenGL context init failed, eglInitialize failed\n");
+			_display = EGL_NO_DISPLAY;
+			return false;
+		}
+		SENDLOG(Info, "EGL %d.%d is initialized, vendor %s\n", major, minor, eglQueryString(_display, EGL_VENDOR));
+
+		if (eglBindAPI(EGL_OPENGL_API) == EGL_FALSE)
+		{
+			SENDLOG(Critical, "EGL OpenGL context init failed, desktop OpenGL isn't supported\n");
+			return false;
+		}
+
+		const EGLint configAttribs[] =
+		{
+			EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+			EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+			EGL_RED_SIZE, channelSizes->red,
+			EGL_GREEN_SIZE, channelSizes->green,
+			EGL_BLUE_SIZE, channelSizes->blue,
+			EGL_ALPHA_SIZE, channelSizes->alpha,
+			EGL_DEPTH_SIZE, (EGLint)depth,
+			EGL_STENCIL_SIZE, (EGLint)stencil,
+			EGL_NONE
+		};
+
+		// the sizes are minimums and larger configs are sorted first, so the exact match is searched for, the first config is the fallback
+		EGLConfig config = nullptr;
+		EGLint numConfigs = 0;
+		bool isPbufferSupported = eglChooseConfig(_display, configAttribs, nullptr, 0, &numConfigs) == EGL_TRUE && numConfigs > 0;
+		if (isPbufferSupported)
+		{
+			vector<EGLConfig> configs(numConfigs);
+			eglChooseConfig(_display, configAttribs, configs.data(), numConfigs, &numConfigs);
+			config = configs[0];
+
+			auto isExactMatch = [this, &channelSizes](EGLConfig candidate)
+			{
+				EGLint red = 0, green = 0, blue = 0, alpha = 0;
+				eglGetConfigAttrib(_display, candidate, EGL_RED_SIZE, &red);
+				eglGetConfigAttrib(_display, candidate, EGL_GREEN_SIZE, &green);
+				eglGetConfigAttrib(_display, candidate, EGL_BLUE_SIZE, &blue);
+				eglGetConfigAttrib(_display, candidate, EGL_ALPHA_SIZE, &alpha);
+				return red == channelSizes->red && green == channelSizes->green && blue == channelSizes->blue && alpha == channelSizes->alpha;
+			};
+			auto exactMatch = std::find_if(configs.begin(), configs.begin() + numConfigs, isExactMatch);
+			if (exactMatch != configs.begin() + numConfigs)
+			{
+				config = *exactMatch;
+			}
+			else
+			{
+				SENDLOG(Warning, "EGL has no config with exactly the requested color channel sizes, using a larger one\n");
+			}
+		}
+		if (isPbufferSupported == false)
+		{
+			// surfaceless drivers may have no pbuffer configs, EGL_KHR_no_config_context lets the context be created without one
+			SENDLOG(Warning, "EGL has no suitable pbuffer config, the context will have no default framebuffer\n");
+			config = nullptr;
+		}
+
+		#ifdef DEBUG
+		constexpr EGLint debugFlag = EGL_TRUE;
+		#else
+		constexpr EGLint debugFlag = EGL_FALSE;
+		#endif
+
+		const EGLint contextAttribs[] =
+		{
+			EGL_CONTEXT_MAJOR_VERSION, 4,
+			EGL_CONTEXT_MINOR_VERSION, 0,
+			EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+			EGL_CONTEXT_OPENGL_FORWARD_COMPATIBLE, EGL_TRUE,
+			EGL_CONTEXT_OPENGL_DEBUG, debugFlag,
+			EGL_NONE
+		};
+
+		_context = eglCreateContext(_display, config, EGL_NO_CONTEXT, contextAttribs);
+		if (_context == EGL_NO_CONTEXT)
+		{
+			SENDLOG(Critical, "EGL OpenGL context init failed, eglCreateContext failed with 0x%x\n", eglGetError());
+			return false;
+		}
+
+		if (isPbufferSupported)
+		{
+			const EGLint surfaceAttribs[] =
+			{
+				EGL_WIDTH, (EGLint)EngineCore::Application::GetMainWindow().width,
+				EGL_HEIGHT, (EGLint)EngineCore::Application::GetMainWindow().height,
+				EGL_NONE
+			};
+
+			_surface = eglCreatePbufferSurface(_display, config, surfaceAttribs);
+			if (_surface == EGL_NO_SURFACE)
+			{
+				SENDLOG(Warning, "EGL failed to create a pbuffer, the context will have no default framebuffer\n");
+			}
+		}
+
+		if (eglMakeCurrent(_display, _surface, _surface, _context) == EGL_FALSE)
+		{
+			SENDLOG(Critical, "EGL OpenGL context init failed, can't make current\n");
+			return false;
+		}
+
+		// glewInit would query GLX, which a surfaceless display doesn't have
+		glewExperimental = GL_TRUE;
+		if (glewContextInit() != GLEW_OK)
+		{
+			SENDLOG(Critical, "EGL OpenGL context init failed, glewContextInit failed\n");
+			return false;
+		}
+		glGetError(); // GLEW's core profile queries may leave GL_INVALID_ENUM
+
+		SENDLOG(Info, "EGL OpenGL context's created, renderer %s\n", (const char *)glGetString(GL_RENDERER));
+
+		return true;
+	}
+};
+
+auto OGLRenderer::OpenGLContextEGL::New(EngineCore::TextureDataFormat colorFormat, ui32 depth, ui32 stencil) -> unique_ptr<class OpenGLContext>
+{
+	auto context = make_unique<OpenGLContextEGLImpl>();
+	if (context->Create(colorFormat, depth, stencil) == false)
+	{
+		return nullptr;
+	}
+	return context;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <Texture.hpp>
+#include "OpenGLContext.hpp"
+
+namespace OGLRenderer
+{
+	// a headless context, renders into a pbuffer of the main window's size, or without a default framebuffer at all if pbuffers aren't supported
+	// works with software drivers such as Mesa's llvmpipe, so the GL backend can run without a GPU and a display server
+	class OpenGLContextEGL : public OpenGLContext
+	{
+	public:
+		virtual EGLDisplay Display() const = 0;
+		virtual EGLContext Context() const = 0;
+		static unique_ptr<class OpenGLContext> New(EngineCore::TextureDataFormat colorFormat, ui32 depth, ui32 stencil);
+	};
+}
\ No newline at end of file
@@ -1,6 +1,11 @@
 #include "BasicHeader.hpp"
 #include "OpenGLRendererProxy.h"
 #include "BackendData.hpp"
+#include "ShaderCompileQueue.hpp"
+#include "GLStateCache.hpp"
+#include "VertexArrayCache.hpp"
+#include "StagingAllocator.hpp"
+#include "SystemUniforms.hpp"
 #include <Application.hpp>
 #include <Logger.hpp>
 #include <Camera.hpp>
@@ -16,6 +21,8 @@
 
 #ifdef WINPLATFORM
 #include "OpenGLContextWindows.hpp"
+#else
+#include "OpenGLContextEGL.hpp"
 #endif
 
 using namespace EngineCore;
@@ -79,21 +86,43 @@ static inline GLenum IndexTypeToOGL(RendererIndexArray::IndexTypet type)
     return GL_INVALID_ENUM;
 }
 
-class OpenGLRendererImpl final : public OpenGLRendererProxy
+class OpenGLRendererImpl final : public OpenGLRendererProxy, private ShaderCompileQueue::Backend
 {
+    ShaderCompileQueue _shaderCompileQueue{*this};
+    std::unordered_set<const Shader *> _failedShaders{}; // a failed compilation deletes the shader's backend data, without this the shader would be enqueued again on every draw
+    ui32 _skippedDrawsCount = 0;
+    ui32 _streamingStallsCount = 0; // locks of streamed arrays that had to wait for the GPU
+    GLStateCache _stateCache{};
+    ui32 _drawCallsCount = 0;
+    RendererFrameStats _lastFrameStats{};
     std::unordered_set<RendererBackendDataBase *> _allocatedBackendDatas{}; // unique_ptr would've been preferable, but using it as a key may be... tricky
     GLuint _emptyVAO = 0;
-    GLuint _intermediateVAO = 0;
+    VertexArrayCache _vertexArrayCache{};
+    StagingAllocator _stagingAllocator{};
+    ui64 _lastBufferId = 0, _lastLayoutId = 0;
     unique_ptr<class OpenGLContext> _context{};
-    array<shared_ptr<const RendererVertexArray>, 8> _boundVertexArrays{};
+    array<shared_ptr<const RendererVertexArray>, VertexArrayCache::VertexArraysLimit> _boundVertexArrays{};
     ui8 _vertexBufferBindingChanged = 0xFF;
     ui8 _boundVertexBuffersThatNotNullptr = 0;
     shared_ptr<const RendererIndexArray> _boundIndexArray{};
     bool _indexBufferBindingChanged = true;
 
+    CameraConstants _cameraConstants{}; // see SystemUniforms.hpp
+    const Matrix4x4 *_cameraViewProjMatrix = nullptr; // set by DrawWithCamera, Camera has it cached already
+    GLuint _cameraUniformBuffer = 0; // UniformBlocks::CameraData, bound to UniformBlocks::CameraBinding for the renderer's lifetime
+    GLuint _indirectBuffer = 0; // RendererIndirectDraw arguments, orphaned on every multi draw
+    ui32 _indirectBufferSize = 0;
+
 public:
     virtual ~OpenGLRendererImpl()
     {
+        _shaderCompileQueue.Clear();
+        _programBinaryCache.Save();
+        _vertexArrayCache.Clear();
+        glDeleteVertexArrays(1, &_emptyVAO);
+        glDeleteBuffers(1, &_cameraUniformBuffer);
+        glDeleteBuffers(1, &_indirectBuffer);
+
         for (auto &data : _allocatedBackendDatas)
         {
             *data->backendDataPointer = nullptr;
@@ -112,24 +141,92 @@ public:
         RendererFrontendDataDirtyState(array, false);
 
         auto &arrayData = *RendererBackendData<ArrayBackendData>(array);
+        arrayData.array = &array;
+
+        bool isStreamed = array.Type() == RendererArray::Typet::VertexArray && array.Access().cpuMode.writeMode == RendererArray::CPUAccessMode::Mode::FrequentFull && (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage);
 
+        if (arrayData.oglBuffer != 0 && (isStreamed || arrayData.streamingMemory != nullptr))
+        {
+            // buffer storage is immutable, so the buffer is recreated
+            arrayData.ReleaseStreaming();
+            glDeleteBuffers(1, &arrayData.oglBuffer);
+            arrayData.oglBuffer = 0;
+        }
         if (arrayData.oglBuffer == 0)
         {
             glGenBuffers(1, &arrayData.oglBuffer);
         }
+        // the storage is recreated, so vertex array objects that use the old id must not be found
+        EvictVertexArrayObjects(arrayData);
+        arrayData.bufferId = ++_lastBufferId;
 
         GLenum type = array.Type() == RendererArray::Typet::VertexArray ? GL_ARRAY_BUFFER : GL_ELEMENT_ARRAY_BUFFER;
         GLenum usage = array.Access().cpuMode.writeMode == RendererArray::CPUAccessMode::Mode::FrequentFull || array.Access().cpuMode.writeMode == RendererArray::CPUAccessMode::Mode::FrequentPartial ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW;
         ui32 size = array.NumberOfElements() * array.Stride();
 
         glBindBuffer(type, arrayData.oglBuffer);
-        glBufferData(type, size, data.get(), usage);
 
-        arrayData.data = move(data);
+        if (isStreamed)
+        {
+            constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(type, size * ArrayBackendData::StreamingRegionsCount, nullptr, flags);
+            arrayData.streamingMemory = (ui8 *)glMapBufferRange(type, 0, size * ArrayBackendData::StreamingRegionsCount, flags);
+            if (arrayData.streamingMemory == nullptr)
+            {
+                SENDLOG(Error, "Failed to map streamed array %*s\n", SVIEWARG(array.Name()));
+                return false;
+            }
+            arrayData.streamingRegionSize = size;
+            if (data != nullptr)
+            {
+                MemOps::Copy(arrayData.streamingMemory, data.get(), size);
+            }
+            arrayData.data = nullptr;
+        }
+        else
+        {
+            glBufferData(type, size, data.get(), usage);
+            arrayData.data = IsShadowed(array) ? DetachTransientData(move(data), size) : nullptr;
+        }
 
         return HasGLErrors() == false;
     }
 
+    // only arrays that can be read back keep a CPU copy of their contents, for the rest it'd be a second copy of the data that's never used
+    static bool IsShadowed(const RendererArray &array)
+    {
+        return array.Access().cpuMode.readMode != RendererArray::CPUAccessMode::Mode::NotAllowed;
+    }
+
+    // moves a streamed array to the next region of its ring, waits if the GPU may still be reading it
+    // FrequentFull means every write replaces the contents, so the previous region isn't copied
+    ui8 *AdvanceStreamingRegion(ArrayBackendData &arrayData)
+    {
+        auto &fences = arrayData.streamingFences;
+
+        glDeleteSync(fences[arrayData.streamingRegion]);
+        fences[arrayData.streamingRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0); // the commands issued so far are the only ones that read the region
+
+        arrayData.streamingRegion = (arrayData.streamingRegion + 1) % ArrayBackendData::StreamingRegionsCount;
+
+        if (GLsync fence = fences[arrayData.streamingRegion])
+        {
+            GLenum waitResult = glClientWaitSync(fence, 0, 0);
+            if (waitResult == GL_TIMEOUT_EXPIRED)
+            {
+                ++_streamingStallsCount;
+                while (waitResult == GL_TIMEOUT_EXPIRED)
+                {
+                    waitResult = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000'000);
+                }
+            }
+            glDeleteSync(fence);
+            fences[arrayData.streamingRegion] = 0;
+        }
+
+        return arrayData.streamingMemory + arrayData.StreamingRegionOffset();
+    }
+
     virtual void UpdateArrayRegion(const RendererArray &array, BufferOwnedData data, ui32 sizeInBytes, ui32 offsetInBytes) override
     {
         assert(RendererBackendData(array) != nullptr);
@@ -142,19 +239,32 @@ public:
             return;
         }
 
+        if (arrayData.streamingMemory != nullptr)
+        {
+            MemOps::Copy(AdvanceStreamingRegion(arrayData) + offsetInBytes, data.get(), sizeInBytes);
+            return;
+        }
+
         GLenum type = array.Type() == RendererArray::Typet::VertexArray ? GL_ARRAY_BUFFER : GL_ELEMENT_ARRAY_BUFFER;
 
         glBindBuffer(type, arrayData.oglBuffer);
         glBufferSubData(type, offsetInBytes, sizeInBytes, data.get());
 
-        ui32 arrayTotalSize = array.NumberOfElements() * array.Stride();
-        if (sizeInBytes == arrayTotalSize)
+        if (IsShadowed(array))
         {
-            arrayData.data = move(data);
-        }
-        else
-        {
-            MemOps::Copy(arrayData.data.get() + offsetInBytes, data.get(), sizeInBytes);
+            ui32 arrayTotalSize = array.NumberOfElements() * array.Stride();
+            if (sizeInBytes == arrayTotalSize)
+            {
+                arrayData.data = DetachTransientData(move(data), sizeInBytes);
+            }
+            else
+            {
+                if (arrayData.data == nullptr)
+                {
+                    arrayData.data = EngineCore::BufferOwnedData{new ui8[arrayTotalSize], [](void *p) {delete[] p; }};
+                }
+                MemOps::Copy(arrayData.data.get() + offsetInBytes, data.get(), sizeInBytes);
+            }
         }
 
         HasGLErrors();
@@ -168,14 +278,25 @@ public:
 
         ui32 arrayTotalSize = array.NumberOfElements() * array.Stride();
 
+        arrayData.lockStart = offsetInBytes;
+        arrayData.lockEnd = arrayData.lockStart + sizeInBytes;
+
+        if (arrayData.streamingMemory != nullptr)
+        {
+            return AdvanceStreamingRegion(arrayData) + offsetInBytes;
+        }
+
+        if (IsShadowed(array) == false)
+        {
+            arrayData.staging = _stagingAllocator.Acquire(sizeInBytes);
+            return arrayData.staging;
+        }
+
         if (arrayData.data == nullptr)
         {
             arrayData.data = EngineCore::BufferOwnedData{new ui8[arrayTotalSize], [](void *p) {delete[] p; }};
         }
 
-        arrayData.lockStart = offsetInBytes;
-        arrayData.lockEnd = arrayData.lockStart + sizeInBytes;
-
         return arrayData.data.get() + offsetInBytes;
     }
 
@@ -196,10 +317,26 @@ public:
             return;
         }
 
+        if (arrayData.streamingMemory != nullptr) // written in place, the mapping is coherent
+        {
+            arrayData.lockStart = arrayData.lockEnd = 0;
+            return;
+        }
+
         GLenum type = array.Type() == RendererArray::Typet::VertexArray ? GL_ARRAY_BUFFER : GL_ELEMENT_ARRAY_BUFFER;
 
         glBindBuffer(type, arrayData.oglBuffer);
-        glBufferSubData(type, arrayData.lockStart, arrayData.lockEnd - arrayData.lockStart, arrayData.data.get() + arrayData.lockStart);
+
+        if (arrayData.staging != nullptr)
+        {
+            glBufferSubData(type, arrayData.lockStart, arrayData.lockEnd - arrayData.lockStart, arrayData.staging);
+            _stagingAllocator.Release(arrayData.staging);
+            arrayData.staging = nullptr;
+        }
+        else
+        {
+            glBufferSubData(type, arrayData.lockStart, arrayData.lockEnd - arrayData.lockStart, arrayData.data.get() + arrayData.lockStart);
+        }
 
         arrayData.lockStart = arrayData.lockEnd = 0;
 
@@ -217,6 +354,13 @@ public:
         assert(castedData != nullptr); // there should be no notification for nullptr datas
         size_t removed = _allocatedBackendDatas.erase(castedData);
         assert(removed == 1);
+        // arrays are deleted right away, their buffers would otherwise stay alive in the vertex array objects that use them
+        // other datas may still be referenced, for example by materials' texture bindings, so they're kept as before
+        if (castedData->type == RendererBackendDataBase::BackendDataType::Array)
+        {
+            EvictVertexArrayObjects(*static_cast<ArrayBackendData *>(castedData));
+            delete castedData;
+        }
     }
 
     OpenGLRendererImpl(unique_ptr<class OpenGLContext> context)
@@ -227,6 +371,34 @@ public:
 
         glGenVertexArrays(1, &_emptyVAO);
 
+        glGenBuffers(1, &_cameraUniformBuffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, _cameraUniformBuffer);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(UniformBlocks::CameraData), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glBindBufferBase(GL_UNIFORM_BUFFER, UniformBlocks::CameraBinding, _cameraUniformBuffer);
+
+        if (GLEW_ARB_parallel_shader_compile)
+        {
+            glMaxShaderCompilerThreadsARB(0xFFFFFFFF); // let the driver decide
+        }
+
+        GLint programBinaryFormatsCount = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &programBinaryFormatsCount);
+        if (programBinaryFormatsCount > 0)
+        {
+            auto glString = [](GLenum name) -> string_view
+            {
+                auto str = (const char *)glGetString(name);
+                return str ? str : "";
+            };
+            string driverId = string(glString(GL_VENDOR)) + '|' + string(glString(GL_RENDERER)) + '|' + string(glString(GL_VERSION));
+            _programBinaryCache = ProgramBinaryCache(FilePath::FromChar("program_binaries.cache"), driverId);
+        }
+        else
+        {
+            SENDLOG(Info, "Program binaries aren't supported, shaders will be compiled from source on every run\n");
+        }
+
     #ifdef DEBUG
         glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
         glDebugMessageCallback(OGLDebugCallback, nullptr);
@@ -304,7 +476,7 @@ public:
         auto clearDepthValue = camera->ClearDepthValue();
         if (clearDepthValue != nullopt)
         {
-			glDepthMask(GL_TRUE);
+			_stateCache.DepthMask(true);
             glClearDepth(*clearDepthValue);
             clearFlags |= GL_DEPTH_BUFFER_BIT;
         }
@@ -371,23 +543,11 @@ public:
             return;
         }
 
-        assert(_intermediateVAO == 0);
-
         if (false == DrawGeneric(rt, cameraPos, viewMatrix, projMatrix, modelMatrix, *pipelineState, *material, topology, numVertices))
         {
-            glDeleteVertexArrays(1, &_intermediateVAO);
-            _intermediateVAO = 0;
             return;
         }
 
-        bool isProcedural = pipelineState->Shader()->InputAttributes().empty();
-
-        if (isProcedural)
-        {
-            assert(_intermediateVAO == 0);
-            glBindVertexArray(_emptyVAO);
-        }
-
         if (instanceCount > 1)
         {
             glDrawArraysInstanced(PrimitiveTopologyToOGL(topology), 0, numVertices, instanceCount);
@@ -396,15 +556,10 @@ public:
         {
             glDrawArrays(PrimitiveTopologyToOGL(topology), 0, numVertices);
         }
+        ++_drawCallsCount;
 
         glUseProgram(0);
 
-        if (isProcedural == false)
-        {
-            glDeleteVertexArrays(1, &_intermediateVAO);
-            _intermediateVAO = 0;
-        }
-
         HasGLErrors();
     }
 
@@ -428,8 +583,6 @@ public:
             return;
         }
 
-        assert(_intermediateVAO == 0);
-
         if (_boundIndexArray == nullptr)
         {
             SENDLOG(Error, "DrawIndexed called with no index buffer bound\n");
@@ -444,8 +597,6 @@ public:
 
         if (false == DrawGeneric(rt, cameraPos, viewMatrix, projMatrix, modelMatrix, *pipelineState, *material, topology, numIndexes))
         {
-            glDeleteVertexArrays(1, &_intermediateVAO);
-            _intermediateVAO = 0;
             return;
         }
 
@@ -456,7 +607,7 @@ public:
             SENDLOG(Error, "Invalid index array\n");
             return;
         }
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexArrayBackendData->oglBuffer);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexArrayBackendData->oglBuffer); // a part of the vertex array object's state, but index arrays aren't in the cache key, so it's always rebound
 
         if (instanceCount > 1)
         {
@@ -466,10 +617,9 @@ public:
         {
             glDrawElements(PrimitiveTopologyToOGL(topology), numIndexes, IndexTypeToOGL(_boundIndexArray->IndexType()), nullptr);
         }
+        ++_drawCallsCount;
 
         glUseProgram(0);
-        glDeleteVertexArrays(1, &_intermediateVAO);
-        _intermediateVAO = 0;
 
         HasGLErrors();
     }
@@ -481,7 +631,9 @@ public:
             SENDLOG(Error, "DrawWithCamera called with null camera\n");
             return;
         }
-        return DrawIntoRenderTarget(camera->RenderTarget().get(), &camera->Position(), &camera->ViewMatrix(), &camera->ProjectionMatrix(), modelMatrix, pipelineState, material, topology, numVertices, instanceCount);
+        _cameraViewProjMatrix = &camera->ViewProjectionMatrix();
+        DrawIntoRenderTarget(camera->RenderTarget().get(), &camera->Position(), &camera->ViewMatrix(), &camera->ProjectionMatrix(), modelMatrix, pipelineState, material, topology, numVertices, instanceCount);
+        _cameraViewProjMatrix = nullptr;
     }
 
     virtual void DrawIndexedWithCamera(const Camera *camera, const struct Matrix4x3 *modelMatrix, const class RendererPipelineState *pipelineState, const class Material *material, PrimitiveTopology topology, ui32 numIndexes, ui32 instanceCount) override
@@ -491,10 +643,92 @@ public:
             SENDLOG(Error, "DrawWithCamera called with null camera\n");
             return;
         }
-        return DrawIndexedIntoRenderTarget(camera->RenderTarget().get(), &camera->Position(), &camera->ViewMatrix(), &camera->ProjectionMatrix(), modelMatrix, pipelineState, material, topology, numIndexes, instanceCount);
+        _cameraViewProjMatrix = &camera->ViewProjectionMatrix();
+        DrawIndexedIntoRenderTarget(camera->RenderTarget().get(), &camera->Position(), &camera->ViewMatrix(), &camera->ProjectionMatrix(), modelMatrix, pipelineState, material, topology, numIndexes, instanceCount);
+        _cameraViewProjMatrix = nullptr;
+    }
+
+    virtual void DrawIndexedIndirectWithCamera(const Camera *camera, const Matrix4x3 *modelMatrix, const RendererPipelineState *pipelineState, const Material *material, PrimitiveTopology topology, span<const RendererIndirectDraw> draws) override
+    {
+        if (camera == nullptr)
+        {
+            SENDLOG(Error, "DrawIndexedIndirectWithCamera called with null camera\n");
+            return;
+        }
+
+        if (pipelineState == nullptr || material == nullptr)
+        {
+            SENDLOG(Error, "DrawIndexedIndirectWithCamera called with nullptr pipeline state or material\n");
+            return;
+        }
+
+        if (draws.empty())
+        {
+            return;
+        }
+
+        if (_boundIndexArray == nullptr || _boundIndexArray->IsLocked())
+        {
+            SENDLOG(Error, "DrawIndexedIndirectWithCamera called with no index buffer bound or the index buffer is still locked\n");
+            return;
+        }
+
+        // DrawGeneric validates only the total, so every draw is checked against the same rule here
+        bool isTriangles = topology == PrimitiveTopology::TriangleEnumeration || topology == PrimitiveTopology::TriangleFan || topology == PrimitiveTopology::TriangleStrip;
+        ui32 totalIndexes = 0;
+        for (const auto &draw : draws)
+        {
+            if (isTriangles && draw.numIndexes % 3)
+            {
+                SENDLOG(Error, "DrawIndexedIndirectWithCamera called with PrimitiveTopology::Triangle, but number of indexes %u of draw %u isn't divisible by 3\n", draw.numIndexes, (ui32)(&draw - draws.data()));
+                return;
+            }
+            totalIndexes += draw.numIndexes;
+        }
+
+        _cameraViewProjMatrix = &camera->ViewProjectionMatrix();
+        bool isReady = DrawGeneric(camera->RenderTarget().get(), &camera->Position(), &camera->ViewMatrix(), &camera->ProjectionMatrix(), modelMatrix, *pipelineState, *material, topology, totalIndexes);
+        _cameraViewProjMatrix = nullptr;
+        if (isReady == false)
+        {
+            return;
+        }
+
+        auto *indexArrayBackendData = RendererBackendData<ArrayBackendData>(*_boundIndexArray);
+        if (indexArrayBackendData == nullptr || indexArrayBackendData->oglBuffer == 0)
+        {
+            SENDLOG(Error, "Invalid index array\n");
+            return;
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexArrayBackendData->oglBuffer);
+
+        GLenum oglTopology = PrimitiveTopologyToOGL(topology);
+        GLenum indexType = IndexTypeToOGL(_boundIndexArray->IndexType());
+
+        // multi draw indirect is core since 4.3, which the renderer already requires for glVertexBindingDivisor
+        static_assert(sizeof(RendererIndirectDraw) == sizeof(GLuint) * 5);
+
+        ui32 size = (ui32)(draws.size() * sizeof(RendererIndirectDraw));
+        if (_indirectBuffer == 0)
+        {
+            glGenBuffers(1, &_indirectBuffer);
+        }
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _indirectBuffer);
+        _indirectBufferSize = std::max(_indirectBufferSize, size);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, _indirectBufferSize, nullptr, GL_STREAM_DRAW); // orphaning, so the draws that are still in flight don't stall the upload
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, size, draws.data());
+
+        glMultiDrawElementsIndirect(oglTopology, indexType, nullptr, (GLsizei)draws.size(), 0);
+        ++_drawCallsCount;
+
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        glUseProgram(0);
+
+        HasGLErrors();
     }
 
-    inline bool DrawGeneric(const class RenderTarget *rt, const Vector3 *cameraPos, const Matrix4x3 *viewMatrix, const Matrix4x4 *projMatrix, const Matrix4x3 *modelMatrix, const RendererPipelineState &pipelineState, const Material &material, PrimitiveTopology topology, ui32 numPoints) // there's currently no caching, no checking of the dirty state
+    inline bool DrawGeneric(const class RenderTarget *rt, const Vector3 *cameraPos, const Matrix4x3 *viewMatrix, const Matrix4x4 *projMatrix, const Matrix4x3 *modelMatrix, const RendererPipelineState &pipelineState, const Material &material, PrimitiveTopology topology, ui32 numPoints)
     {
         if (rt == nullptr)
         {
@@ -533,10 +767,24 @@ public:
             return false;
         }
 
-        const auto &shader = material.Shader();
-        if (CheckShaderBackendData(*shader))
+        auto shader = material.BoundShader();
+        if (_shaderCompileQueue.IsQueued(*shader))
         {
+            ++_skippedDrawsCount;
+            return false;
+        }
+        if (IsFailedShader(*shader))
+        {
+            ++_skippedDrawsCount;
+            return false;
+        }
+        if (RendererBackendData(*shader) == nullptr || RendererFrontendDataDirtyState(*shader))
+        {
+            // compiling here would stall the frame, the draw is skipped until the program is ready
+            _shaderCompileQueue.Enqueue(material.Shader()); // the queue owns the shaders it compiles
             RendererFrontendDataDirtyState(material, true);
+            ++_skippedDrawsCount;
+            return false;
         }
         if (RendererBackendData(*shader) == nullptr)
         {
@@ -558,56 +806,26 @@ public:
 
         glUseProgram(shaderBackendData.program);
 
-        assert(_intermediateVAO == 0);
-
-        for (ui32 attributeIndex = 0; attributeIndex < material.Shader()->InputAttributes().size(); ++attributeIndex)
+        if (shaderBackendData.materialBlockSize)
         {
-            if (_intermediateVAO == 0)
-            {
-                glGenVertexArrays(1, &_intermediateVAO);
-                glBindVertexArray(_intermediateVAO);
-            }
-
-            auto glAttribLocation = shaderBackendData.attributeLocations[attributeIndex];
-            const auto &shaderInputAttribute = material.Shader()->InputAttributes()[attributeIndex];
-            const auto &pipelineLayoutAttributes = pipelineState.VertexDataLayout().Attributes();
-
-            const auto &pipelineAttribute = std::find_if(pipelineLayoutAttributes.begin(), pipelineLayoutAttributes.end(), [&shaderInputAttribute](const VertexLayout::Attribute &pipelineLayoutAttribute) {return pipelineLayoutAttribute.Name() == shaderInputAttribute; });
-            if (pipelineAttribute == pipelineLayoutAttributes.end())
+            if (materialBackendData.uniformBufferSize != shaderBackendData.materialBlockSize)
             {
-                SENDLOG(Error, "Shader %*s has input attribute %*s, but RendererPipelineState's vertex layout doesn't provide it\n", SVIEWARG(material.Shader()->Name()), SVIEWARG(shaderInputAttribute));
-                return false;
-            }
-
-            const auto &vertexBuffer = _boundVertexArrays[pipelineAttribute->VertexArrayNumber()];
-            assert(vertexBuffer->Type() == RendererArray::Typet::VertexArray);
-
-            if (vertexBuffer->IsLocked())
-            {
-                SENDLOG(Error, "Draw called, but vertex buffer %*s it uses is still locked\n", SVIEWARG(vertexBuffer->Name()));
-                return false;
+                // the material has been updated before its shader was ready
+                RendererFrontendDataDirtyState(material, true);
+                CheckMaterialBackendData(material);
             }
+            glBindBufferRange(GL_UNIFORM_BUFFER, UniformBlocks::MaterialBinding, materialBackendData.uniformBuffer, 0, materialBackendData.uniformBufferSize);
+        }
 
-            auto *vertexBufferBackendData = RendererBackendData<ArrayBackendData>(*vertexBuffer);
-            if (vertexBufferBackendData == nullptr || vertexBufferBackendData->oglBuffer == 0)
-            {
-                SENDLOG(Error, "Invalid vertex buffer\n");
-                return false;
-            }
-
-            //glBindVertexArray(pipelineAttribute->VertexBufferNumber(), vertexBufferBackendData->oglBuffer, 0, vertexBuffer->Stride());
-
-            auto sizeAndType = VertexAttributeTypeToOGL(pipelineAttribute->Format());
-            //glVertexAttribFormat(glAttribLocation, sizeAndType.first, sizeAndType.second, GL_FALSE, *pipelineAttribute->VertexBufferOffset());
-
-            glBindBuffer(GL_ARRAY_BUFFER, vertexBufferBackendData->oglBuffer);
-            glEnableVertexAttribArray(glAttribLocation);
-			uiw vertexArrayOffset = *pipelineAttribute->VertexArrayOffset();
-            glVertexAttribPointer(glAttribLocation, sizeAndType.first, sizeAndType.second, GL_FALSE, vertexBuffer->Stride(), reinterpret_cast<void *>(vertexArrayOffset));
-
-            //glVertexAttribBinding()
+        const auto *pipelineStateBackendData = CheckPipelineStateBackendData(pipelineState, *shader, shaderBackendData);
+        if (pipelineStateBackendData == nullptr)
+        {
+            return false;
+        }
 
-            glVertexBindingDivisor(glAttribLocation, pipelineAttribute->InstanceStep().value_or(0));
+        if (false == BindVertexArrayObject(*pipelineStateBackendData))
+        {
+            return false;
         }
 
         GLenum curTexUnit = 0;
@@ -624,7 +842,11 @@ public:
             case Shader::Uniform::Type::F32:
             case Shader::Uniform::Type::I32:
             case Shader::Uniform::Type::UI32:
-                if (shaderUniform.elementHeight > 1)
+                if (oglUniform.setFuncAddress == 0)
+                {
+                    // a member of the material's uniform block
+                }
+                else if (shaderUniform.elementHeight > 1)
                 {
                     auto func = (ShaderBackendData::SetMatrixUniformFunction)oglUniform.setFuncAddress;
                     func(oglUniform.location, shaderUniform.elementsCount, GL_FALSE, (GLfloat *)uniformsMemory);
@@ -669,121 +891,238 @@ public:
             }
         }
 
-		auto setSystemUniform = [&shader, &systemOglUniforms = shaderBackendData.systemOglUniforms](string_view uniformName, auto uniformValue, auto uniformSetFunction)
-		{
-			auto uniformSearch = std::find_if(shader->SystemUniforms().begin(), shader->SystemUniforms().end(), [uniformName](const Shader::Uniform &uniform) { return uniform.name == uniformName; });
-			if (uniformSearch != shader->SystemUniforms().end())
-			{
-				auto index = uniformSearch - shader->SystemUniforms().begin();
-				const auto &oglUniform = systemOglUniforms[index];
-
-				std::remove_const_t<std::remove_reference_t<std::remove_pointer_t<std::remove_cv_t<decltype(uniformValue)>>>> uniform;
-				if (uniformValue)
-				{
-					uniform = *uniformValue;
-				}
-
-				uniformSetFunction(oglUniform, uniform);
-			}
-		};
-
-		auto setMatrix = [](const ShaderBackendData::OGLUniform &oglUniform, const auto &matrix)
-		{
-			reinterpret_cast<ShaderBackendData::SetMatrixUniformFunction>(oglUniform.setFuncAddress)(oglUniform.location, 1, GL_FALSE, matrix.Data().data());
-		};
-
-		auto setFloats = [](const ShaderBackendData::OGLUniform &oglUniform, const auto &values)
-		{
-			reinterpret_cast<ShaderBackendData::SetUniformFunction>(oglUniform.setFuncAddress)(oglUniform.location, 1, values.Data().data());
-		};
-
-		Matrix4x4 viewProjMatrix;
-		if (viewMatrix && projMatrix)
-		{
-			viewProjMatrix = *viewMatrix * *projMatrix;
-		}
-
-		Vector3 cameraForwardVector, cameraRightVector, cameraUpVector;
-		if (viewMatrix)
-		{
-			cameraForwardVector = viewMatrix->GetColumn(2).ToVector3();
-			cameraRightVector = viewMatrix->GetColumn(0).ToVector3();
-			cameraUpVector = viewMatrix->GetColumn(1).ToVector3();
-		}
-
-		setSystemUniform("_ModelMatrix", modelMatrix, setMatrix);
-		setSystemUniform("_ViewMatrix", viewMatrix, setMatrix);
-		setSystemUniform("_ProjectionMatrix", projMatrix, setMatrix);
-		setSystemUniform("_ViewProjectionMatrix", viewMatrix &&projMatrix ? &viewProjMatrix : nullptr, setMatrix);
-		setSystemUniform("_CameraPosition", cameraPos, setFloats);
-		setSystemUniform("_CameraForwardVector", viewMatrix ? &cameraForwardVector : nullptr, setFloats);
-		setSystemUniform("_CameraRightVector", viewMatrix ? &cameraRightVector : nullptr, setFloats);
-		setSystemUniform("_CameraUpVector", viewMatrix ? &cameraUpVector : nullptr, setFloats);
+		const auto &cameraConstants = UpdateCameraConstants(cameraPos, viewMatrix, projMatrix);
+		SetSystemUniforms<ShaderBackendData::SetMatrixUniformFunction, ShaderBackendData::SetUniformFunction>(shaderBackendData.systemOglUniforms, cameraConstants, modelMatrix);
+
+        return true;
+    }
+
+    // matches the pipeline's vertex layout against the shader's input attributes, redone only when either of them changes
+    const PipelineStateBackendData *CheckPipelineStateBackendData(const RendererPipelineState &pipelineState, const Shader &shader, const ShaderBackendData &shaderBackendData)
+    {
+        if (RendererBackendData(pipelineState) == nullptr)
+        {
+            OpenGLRendererProxy::AllocateBackendData<PipelineStateBackendData>(pipelineState);
+            RendererFrontendDataDirtyState(pipelineState, true);
+        }
+
+        auto &data = *RendererBackendData<PipelineStateBackendData>(pipelineState);
+
+        if (RendererFrontendDataDirtyState(pipelineState) == false && data.resolvedShader == &shader && data.resolvedProgram == shaderBackendData.program)
+        {
+            return &data;
+        }
+
+        data.resolvedShader = nullptr;
+        data.resolvedProgram = 0;
+        data.resolvedAttributes.clear();
+
+        const auto &pipelineLayoutAttributes = pipelineState.VertexDataLayout().Attributes();
+
+        for (ui32 attributeIndex = 0; attributeIndex < shader.InputAttributes().size(); ++attributeIndex)
+        {
+            const auto &shaderInputAttribute = shader.InputAttributes()[attributeIndex];
+
+            const auto &pipelineAttribute = std::find_if(pipelineLayoutAttributes.begin(), pipelineLayoutAttributes.end(), [&shaderInputAttribute](const VertexLayout::Attribute &pipelineLayoutAttribute) {return pipelineLayoutAttribute.Name() == shaderInputAttribute; });
+            if (pipelineAttribute == pipelineLayoutAttributes.end())
+            {
+                SENDLOG(Error, "Shader %*s has input attribute %*s, but RendererPipelineState's vertex layout doesn't provide it\n", SVIEWARG(shader.Name()), SVIEWARG(shaderInputAttribute));
+                return nullptr;
+            }
+
+            auto sizeAndType = VertexAttributeTypeToOGL(pipelineAttribute->Format());
+            data.resolvedAttributes.push_back({shaderBackendData.attributeLocations[attributeIndex], pipelineAttribute->VertexArrayNumber(), sizeAndType.first, sizeAndType.second, *pipelineAttribute->VertexArrayOffset(), pipelineAttribute->InstanceStep().value_or(0)});
+        }
+
+        data.resolvedShader = &shader;
+        data.resolvedProgram = shaderBackendData.program;
+        data.layoutId = ++_lastLayoutId;
+        RendererFrontendDataDirtyState(pipelineState, false);
+
+        return &data;
+    }
+
+    // binds a cached vertex array object for the resolved layout and the currently bound vertex arrays, creates it on a miss
+    // vertex array objects reference their buffers, so the buffers' storage would outlive deletion until the entries are evicted
+    void EvictVertexArrayObjects(const ArrayBackendData &arrayData)
+    {
+        if (arrayData.bufferId != 0)
+        {
+            ui64 firstId = arrayData.bufferId * ArrayBackendData::StreamingRegionsCount;
+            _vertexArrayCache.EvictBuffers(firstId, firstId + ArrayBackendData::StreamingRegionsCount - 1);
+        }
+    }
+
+    bool BindVertexArrayObject(const PipelineStateBackendData &pipelineStateBackendData)
+    {
+        if (pipelineStateBackendData.resolvedAttributes.empty())
+        {
+            glBindVertexArray(_emptyVAO);
+            return true;
+        }
+
+        VertexArrayCache::Key key;
+        key.layoutId = pipelineStateBackendData.layoutId;
+
+        for (const auto &attribute : pipelineStateBackendData.resolvedAttributes)
+        {
+            const auto &vertexBuffer = _boundVertexArrays[attribute.vertexArrayNumber];
+            assert(vertexBuffer->Type() == RendererArray::Typet::VertexArray);
+
+            if (vertexBuffer->IsLocked())
+            {
+                SENDLOG(Error, "Draw called, but vertex buffer %*s it uses is still locked\n", SVIEWARG(vertexBuffer->Name()));
+                return false;
+            }
+
+            auto *vertexBufferBackendData = RendererBackendData<ArrayBackendData>(*vertexBuffer);
+            if (vertexBufferBackendData == nullptr || vertexBufferBackendData->oglBuffer == 0)
+            {
+                SENDLOG(Error, "Invalid vertex buffer\n");
+                return false;
+            }
+
+            // streamed arrays get a vertex array object per region, their offsets differ
+            key.bufferIds[attribute.vertexArrayNumber] = vertexBufferBackendData->bufferId * ArrayBackendData::StreamingRegionsCount + vertexBufferBackendData->streamingRegion;
+        }
+
+        GLuint vao = _vertexArrayCache.Find(key);
+        if (vao != 0)
+        {
+            glBindVertexArray(vao);
+            return true;
+        }
+
+        glGenVertexArrays(1, &vao);
+        glBindVertexArray(vao);
 
+        for (const auto &attribute : pipelineStateBackendData.resolvedAttributes)
+        {
+            const auto &vertexBuffer = _boundVertexArrays[attribute.vertexArrayNumber];
+            const auto &vertexBufferBackendData = *RendererBackendData<ArrayBackendData>(*vertexBuffer);
+            glBindBuffer(GL_ARRAY_BUFFER, vertexBufferBackendData.oglBuffer);
+            glEnableVertexAttribArray(attribute.location);
+            glVertexAttribPointer(attribute.location, attribute.componentsCount, attribute.componentType, GL_FALSE, vertexBuffer->Stride(), reinterpret_cast<void *>(attribute.offset + vertexBufferBackendData.StreamingRegionOffset()));
+            glVertexBindingDivisor(attribute.location, attribute.divisor);
+        }
+
+        _vertexArrayCache.Insert(key, vao);
         return true;
     }
 
+    const CameraConstants &UpdateCameraConstants(const Vector3 *cameraPos, const Matrix4x3 *viewMatrix, const Matrix4x4 *projMatrix)
+    {
+        auto isSame = [](const auto *value, const auto &cached)
+        {
+            if (value == nullptr || !cached)
+            {
+                return value == nullptr && !cached;
+            }
+            return std::memcmp(value, &*cached, sizeof(*value)) == 0;
+        };
+
+        auto &constants = _cameraConstants;
+        if (isSame(cameraPos, constants.position) && isSame(viewMatrix, constants.viewMatrix) && isSame(projMatrix, constants.projMatrix))
+        {
+            return constants;
+        }
+
+        constants.position = cameraPos ? optional<Vector3>(*cameraPos) : nullopt;
+        constants.viewMatrix = viewMatrix ? optional<Matrix4x3>(*viewMatrix) : nullopt;
+        constants.projMatrix = projMatrix ? optional<Matrix4x4>(*projMatrix) : nullopt;
+
+        constants.viewProjMatrix = {};
+        if (viewMatrix && projMatrix)
+        {
+            constants.viewProjMatrix = _cameraViewProjMatrix ? *_cameraViewProjMatrix : *viewMatrix * *projMatrix;
+        }
+
+        constants.forwardVector = constants.rightVector = constants.upVector = {};
+        if (viewMatrix)
+        {
+            constants.forwardVector = viewMatrix->GetColumn(2).ToVector3();
+            constants.rightVector = viewMatrix->GetColumn(0).ToVector3();
+            constants.upVector = viewMatrix->GetColumn(1).ToVector3();
+        }
+
+        UniformBlocks::CameraData data{};
+        MemOps::Copy(data.viewProjMatrix.data(), constants.viewProjMatrix.Data().data(), 16);
+        MemOps::Copy(data.projMatrix.data(), constants.projMatrix.value_or(Matrix4x4{}).Data().data(), 16);
+        Matrix4x3 view = constants.viewMatrix.value_or(Matrix4x3{});
+        for (uiw column = 0; column < 4; ++column)
+        {
+            MemOps::Copy(data.viewMatrix.data() + column * 4, view.Data().data() + column * 3, 3);
+        }
+        Vector3 position = constants.position.value_or(Vector3{});
+        MemOps::Copy(data.position.data(), position.Data().data(), 3);
+        MemOps::Copy(data.forwardVector.data(), constants.forwardVector.Data().data(), 3);
+        MemOps::Copy(data.rightVector.data(), constants.rightVector.Data().data(), 3);
+        MemOps::Copy(data.upVector.data(), constants.upVector.Data().data(), 3);
+
+        glBindBuffer(GL_UNIFORM_BUFFER, _cameraUniformBuffer);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(data), &data, GL_DYNAMIC_DRAW); // orphans the storage, so draws that use the previous data don't stall
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+        return constants;
+    }
+
     void ApplyPipelineState(const RendererPipelineState &state)
     {
         switch (state.PolygonFillMode())
         {
         case RendererPipelineState::PolygonFillModet::Solid:
-            glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+            _stateCache.PolygonMode(GL_FILL);
             break;
         case RendererPipelineState::PolygonFillModet::Wireframe:
-            glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+            _stateCache.PolygonMode(GL_LINE);
             break;
         }
 
         switch (state.PolygonCullMode())
         {
         case RendererPipelineState::PolygonCullModet::Back:
-            glEnable(GL_CULL_FACE);
-            glCullFace(GL_BACK);
+            _stateCache.CullFace(true, GL_BACK);
             break;
         case RendererPipelineState::PolygonCullModet::Front:
-            glEnable(GL_CULL_FACE);
-            glCullFace(GL_FRONT);
+            _stateCache.CullFace(true, GL_FRONT);
             break;
         case RendererPipelineState::PolygonCullModet::None:
-            glDisable(GL_CULL_FACE);
+            _stateCache.CullFace(false, GL_BACK);
             break;
         }
 
-        glEnable(GL_DEPTH_TEST);
+        _stateCache.DepthTest(true);
         switch (state.DepthComparisonFunc())
         {
         case RendererPipelineState::DepthComparisonFunct::Always:
-            glDepthFunc(GL_ALWAYS);
+            _stateCache.DepthFunc(GL_ALWAYS);
             break;
         case RendererPipelineState::DepthComparisonFunct::Equal:
-            glDepthFunc(GL_EQUAL);
+            _stateCache.DepthFunc(GL_EQUAL);
             break;
         case RendererPipelineState::DepthComparisonFunct::Greater:
-            glDepthFunc(GL_GREATER);
+            _stateCache.DepthFunc(GL_GREATER);
             break;
         case RendererPipelineState::DepthComparisonFunct::GreaterEqual:
-            glDepthFunc(GL_GEQUAL);
+            _stateCache.DepthFunc(GL_GEQUAL);
             break;
         case RendererPipelineState::DepthComparisonFunct::Less:
-            glDepthFunc(GL_LESS);
+            _stateCache.DepthFunc(GL_LESS);
             break;
         case RendererPipelineState::DepthComparisonFunct::LessEqual:
-            glDepthFunc(GL_LEQUAL);
+            _stateCache.DepthFunc(GL_LEQUAL);
             break;
         case RendererPipelineState::DepthComparisonFunct::Never:
-            glDepthFunc(GL_NEVER);
+            _stateCache.DepthFunc(GL_NEVER);
             break;
         case RendererPipelineState::DepthComparisonFunct::NotEqual:
-            glDepthFunc(GL_NOTEQUAL);
+            _stateCache.DepthFunc(GL_NOTEQUAL);
             break;
         }
 
-        glDepthMask(state.EnableDepthWrite() ? GL_TRUE : GL_FALSE);
-
-        glFrontFace(state.PolygonFrontIsCounterClockwise() ? GL_CCW : GL_CW);
+        _stateCache.DepthMask(state.EnableDepthWrite());
 
-        auto blend = state.BlendSettings();
+        _stateCache.FrontFace(state.PolygonFrontIsCounterClockwise() ? GL_CCW : GL_CW);
 
         auto blendFactorToOGL = [](RendererPipelineState::BlendFactort factor) -> GLenum
         {
@@ -837,19 +1176,130 @@ public:
 
         for (ui32 rtIndex = 0; rtIndex < RenderTargetsLimit; ++rtIndex)
         {
-            blend.isEnabled ? glEnablei(GL_BLEND, rtIndex) : glDisablei(GL_BLEND, rtIndex);
-            glBlendFuncSeparatei(rtIndex, blendFactorToOGL(blend.sourceColorFactor), blendFactorToOGL(blend.targetColorFactor), blendFactorToOGL(blend.sourceAlphaFactor), blendFactorToOGL(blend.targetAlphaFactor));
-            glBlendEquationSeparatei(rtIndex, blendCombineModeToOGL(blend.colorCombineMode), blendCombineModeToOGL(blend.alphaCombineMode));
+            auto blend = state.BlendSettings(rtIndex);
+            _stateCache.Blend(rtIndex, {blend.isEnabled,
+                blendFactorToOGL(blend.sourceColorFactor), blendFactorToOGL(blend.targetColorFactor), blendFactorToOGL(blend.sourceAlphaFactor), blendFactorToOGL(blend.targetAlphaFactor),
+                blendCombineModeToOGL(blend.colorCombineMode), blendCombineModeToOGL(blend.alphaCombineMode)});
         }
     }
 
     virtual void BeginFrame() override
     {
         _context->MakeCurrent();
+        _shaderCompileQueue.Update();
     }
 
     virtual void EndFrame() override
-    {}
+    {
+        const auto &stateCounters = _stateCache.CurrentCounters();
+        _lastFrameStats = {_drawCallsCount, stateCounters.issuedCalls, stateCounters.skippedCalls};
+        _drawCallsCount = 0;
+        _stateCache.ResetCounters();
+
+        _stagingAllocator.EndFrame();
+        ResetTransientAllocator();
+
+        if (_streamingStallsCount)
+        {
+            SENDLOG(Info, "Streamed arrays waited for the GPU %u times, consider more streaming regions\n", _streamingStallsCount);
+            _streamingStallsCount = 0;
+        }
+
+        if (_skippedDrawsCount)
+        {
+            SENDLOG(Info, "Skipped %u draws, their shaders are still being compiled\n", _skippedDrawsCount);
+            _skippedDrawsCount = 0;
+        }
+    }
+
+    virtual RendererFrameStats LastFrameStats() const override
+    {
+        return _lastFrameStats;
+    }
+
+    virtual vector<RendererArrayMemory> ArraysMemory() const override
+    {
+        vector<RendererArrayMemory> result;
+        for (const auto *data : _allocatedBackendDatas)
+        {
+            if (data->type != RendererBackendDataBase::BackendDataType::Array)
+            {
+                continue;
+            }
+            const auto &arrayData = *static_cast<const ArrayBackendData *>(data);
+            if (arrayData.array == nullptr)
+            {
+                continue;
+            }
+
+            ui64 size = (ui64)arrayData.array->NumberOfElements() * arrayData.array->Stride();
+            RendererArrayMemory memory;
+            memory.name = arrayData.array->Name();
+            memory.gpuBytes = arrayData.oglBuffer ? (arrayData.streamingMemory ? size * ArrayBackendData::StreamingRegionsCount : size) : 0;
+            memory.shadowBytes = arrayData.data ? size : 0;
+            memory.stagingBytes = arrayData.staging ? arrayData.lockEnd - arrayData.lockStart : 0;
+            result.push_back(memory);
+        }
+        return result;
+    }
+
+    virtual void PrecompileShaders(span<const shared_ptr<Shader>> shaders, bool isBlocking) override
+    {
+        for (const auto &shader : shaders)
+        {
+            auto *backendData = RendererBackendData<ShaderBackendData>(*shader);
+            if (backendData == nullptr || RendererFrontendDataDirtyState(*shader))
+            {
+                _shaderCompileQueue.Enqueue(shader);
+            }
+        }
+
+        if (isBlocking)
+        {
+            _shaderCompileQueue.Flush();
+        }
+    }
+
+    virtual bool BeginCompilation(const Shader &shader) override
+    {
+        if (BeginShaderCompilation(shader))
+        {
+            return true;
+        }
+        _failedShaders.insert(&shader);
+        return false;
+    }
+
+    virtual bool IsCompilationComplete(const Shader &shader) override
+    {
+        return IsShaderCompilationComplete(shader);
+    }
+
+    virtual bool FinishCompilation(const Shader &shader) override
+    {
+        if (FinishShaderCompilation(shader))
+        {
+            return true;
+        }
+        _failedShaders.insert(&shader);
+        return false;
+    }
+
+    // the shader is retried once it's marked dirty, which is also the state of a newly created shader, so a shader that reuses a failed one's address isn't skipped
+    bool IsFailedShader(const Shader &shader)
+    {
+        auto it = _failedShaders.find(&shader);
+        if (it == _failedShaders.end())
+        {
+            return false;
+        }
+        if (RendererFrontendDataDirtyState(shader))
+        {
+            _failedShaders.erase(it);
+            return false;
+        }
+        return true;
+    }
 
     virtual void SwapBuffers() override
     {
@@ -893,6 +1343,7 @@ public:
         }
 
         data->backendDataPointer = backendDataPointer;
+        data->type = type;
         *backendDataPointer = data;
         auto it = _allocatedBackendDatas.insert(data);
         if (it.second == false)
@@ -914,6 +1365,10 @@ public:
         if (castedData != nullptr)
         {
             *castedData->backendDataPointer = nullptr;
+            if (castedData->type == RendererBackendDataBase::BackendDataType::Array)
+            {
+                EvictVertexArrayObjects(*static_cast<ArrayBackendData *>(castedData));
+            }
             delete castedData;
             size_t removed = _allocatedBackendDatas.erase(castedData);
             assert(removed == 1);
@@ -925,8 +1380,15 @@ shared_ptr<OpenGLRenderer> OpenGLRenderer::New(bool isFullscreen, EngineCore::Te
 {
 #ifdef WINPLATFORM
     auto context = OpenGLContextWindows::New(isFullscreen, colorFormat, depth, stencil, window);
+#else
+    auto context = OpenGLContextEGL::New(colorFormat, depth, stencil); // always headless, isFullscreen and window don't apply
 #endif
 
+    if (context == nullptr)
+    {
+        return nullptr;
+    }
+
     return make_shared<OpenGLRendererImpl>(move(context));
 }
 
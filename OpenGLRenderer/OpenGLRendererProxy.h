@@ -2,18 +2,27 @@
 
 #include "OpenGLRenderer.hpp"
 #include "BackendData.hpp"
+#include "ProgramBinaryCache.hpp"
 
 namespace OGLRenderer
 {
     class OpenGLRendererProxy : public OpenGLRenderer
     {
     protected:
+        ProgramBinaryCache _programBinaryCache{};
+
         static bool HasGLErrors();
 
         // if true has been returned from a Check* function, it means the backdata had been updated
         bool CheckMaterialBackendData(const EngineCore::Material &material);
         bool CheckRenderTargetBackendData(const EngineCore::RenderTarget &rt);
         bool CheckShaderBackendData(const EngineCore::Shader &shader);
+
+        // CheckShaderBackendData is Begin followed by Finish, split so compilation can proceed in the background
+        bool BeginShaderCompilation(const EngineCore::Shader &shader); // returns false if the compilation couldn't be started, the backend data is deleted then
+        bool IsShaderCompilationComplete(const EngineCore::Shader &shader); // doesn't block
+        bool FinishShaderCompilation(const EngineCore::Shader &shader); // blocks until the program is linked, returns false if it failed
+
         bool CheckTextureSamplerBackendData(const EngineCore::TextureSampler &sampler);
         bool CheckTextureBackendData(const EngineCore::Texture &texture);
         bool CreateTextureRegion(const EngineCore::Texture &texture, EngineCore::BufferOwnedData data, EngineCore::TextureDataFormat dataFormat);
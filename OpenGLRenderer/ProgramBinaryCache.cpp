@@ -0,0 +1,184 @@
+#include "BasicHeader.hpp"
+#include "ProgramBinaryCache.hpp"
+#include <Logger.hpp>
+
+using namespace EngineCore;
+using namespace OGLRenderer;
+
+namespace
+{
+    // FNV-1a, the value is persisted, so std::hash can't be used
+    ui64 Hash(string_view data, ui64 hash = 14695981039346656037ull)
+    {
+        for (char ch : data)
+        {
+            hash ^= (ui8)ch;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+}
+
+ProgramBinaryCache::ProgramBinaryCache(const FilePath &path, string_view driverId) : _path(path), _driverHash(Hash(driverId)), _isEnabled(true)
+{
+    File file = File(path, FileOpenMode::OpenExisting, FileProcModes::Read);
+    if (!file.IsOpen())
+    {
+        SENDLOG(Info, "Program binary cache " PTHSTR " doesn't exist yet\n", path.PlatformPath().data());
+        return;
+    }
+
+    MemoryMappedFile mapping = MemoryMappedFile(file);
+    if (!mapping.IsOpen())
+    {
+        SENDLOG(Warning, "Failed to map program binary cache " PTHSTR "\n", path.PlatformPath().data());
+        return;
+    }
+
+    if (!Deserialize(mapping.CMemory(), mapping.Size()))
+    {
+        SENDLOG(Info, "Program binary cache " PTHSTR " is outdated or malformed, it'll be rebuilt\n", path.PlatformPath().data());
+        _isModified = true;
+        return;
+    }
+
+    SENDLOG(Info, "Loaded %u program binaries from " PTHSTR "\n", (ui32)_entries.size(), path.PlatformPath().data());
+}
+
+bool ProgramBinaryCache::IsEnabled() const
+{
+    return _isEnabled;
+}
+
+ui64 ProgramBinaryCache::Key(string_view vsCode, string_view psCode) const
+{
+    ui64 hash = Hash(vsCode, _driverHash);
+    hash = Hash(string_view("\0", 1), hash); // so moving code between the stages changes the key
+    return Hash(psCode, hash);
+}
+
+auto ProgramBinaryCache::Find(ui64 key) const -> optional<Binary>
+{
+    auto searchResult = _entries.find(key);
+    if (searchResult == _entries.end())
+    {
+        return nullopt;
+    }
+    return Binary{searchResult->second.format, searchResult->second.data};
+}
+
+void ProgramBinaryCache::Store(ui64 key, ui32 format, vector<ui8> &&data)
+{
+    if (!_isEnabled)
+    {
+        return;
+    }
+    _entries[key] = Entry{format, move(data)};
+    _isModified = true;
+}
+
+void ProgramBinaryCache::Remove(ui64 key)
+{
+    if (_entries.erase(key))
+    {
+        _isModified = true;
+    }
+}
+
+uiw ProgramBinaryCache::Size() const
+{
+    return _entries.size();
+}
+
+bool ProgramBinaryCache::Save()
+{
+    if (!_isEnabled || !_isModified)
+    {
+        return true;
+    }
+
+    File file = File(_path, FileOpenMode::CreateAlways, FileProcModes::Write);
+    if (!file.IsOpen())
+    {
+        SENDLOG(Warning, "Failed to create program binary cache " PTHSTR "\n", _path.PlatformPath().data());
+        return false;
+    }
+
+    vector<ui8> data = Serialize();
+    if (!file.Write(data.data(), (ui32)data.size()))
+    {
+        SENDLOG(Warning, "Failed to write program binary cache " PTHSTR "\n", _path.PlatformPath().data());
+        return false;
+    }
+
+    _isModified = false;
+    return true;
+}
+
+vector<ui8> ProgramBinaryCache::Serialize() const
+{
+    uiw size = sizeof(Header);
+    for (const auto &[key, entry] : _entries)
+    {
+        size += sizeof(EntryHeader) + entry.data.size();
+    }
+
+    vector<ui8> data(size);
+    ui8 *target = data.data();
+
+    Header header;
+    header.driverHash = _driverHash;
+    header.entriesCount = (ui32)_entries.size();
+    MemOps::Copy(target, (const ui8 *)&header, sizeof(header));
+    target += sizeof(header);
+
+    for (const auto &[key, entry] : _entries)
+    {
+        EntryHeader entryHeader{key, entry.format, (ui32)entry.data.size()};
+        MemOps::Copy(target, (const ui8 *)&entryHeader, sizeof(entryHeader));
+        target += sizeof(entryHeader);
+        MemOps::Copy(target, entry.data.data(), entry.data.size());
+        target += entry.data.size();
+    }
+
+    return data;
+}
+
+bool ProgramBinaryCache::Deserialize(const ui8 *data, uiw size)
+{
+    _entries.clear();
+
+    Header header;
+    if (size < sizeof(header))
+    {
+        return false;
+    }
+    MemOps::Copy((ui8 *)&header, data, sizeof(header));
+    if (header.signature != Header::SignatureValue || header.version != Header::CurrentVersion || header.driverHash != _driverHash)
+    {
+        return false;
+    }
+
+    uiw offset = sizeof(header);
+    for (ui32 index = 0; index < header.entriesCount; ++index)
+    {
+        EntryHeader entryHeader;
+        if (size - offset < sizeof(entryHeader))
+        {
+            _entries.clear();
+            return false;
+        }
+        MemOps::Copy((ui8 *)&entryHeader, data + offset, sizeof(entryHeader));
+        offset += sizeof(entryHeader);
+
+        if (size - offset < entryHeader.size)
+        {
+            _entries.clear();
+            return false;
+        }
+        _entries[entryHeader.key] = Entry{entryHeader.format, vector<ui8>(data + offset, data + offset + entryHeader.size)};
+        offset += entryHeader.size;
+    }
+
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <unordered_map>
+
+namespace OGLRenderer
+{
+    // on-disk cache of linked program binaries
+    // a binary is only valid for the driver that produced it, so the driver string is a part of both the keys and the file header,
+    // a file written by another driver is discarded as a whole, binaries that are rejected by the driver should be removed
+    // doesn't call OpenGL itself, formats are stored as plain integers
+    class ProgramBinaryCache
+    {
+    public:
+        struct Header
+        {
+            static constexpr ui32 SignatureValue = 'C' << 24 | 'B' << 16 | 'G' << 8 | 'P';
+            static constexpr ui32 CurrentVersion = 1;
+
+            ui32 signature = SignatureValue;
+            ui32 version = CurrentVersion;
+            ui64 driverHash = 0;
+            ui32 entriesCount = 0;
+            ui32 reserved = 0;
+        };
+
+        // followed by size bytes of the binary
+        struct EntryHeader
+        {
+            ui64 key;
+            ui32 format;
+            ui32 size;
+        };
+
+        struct Binary
+        {
+            ui32 format;
+            span<const ui8> data;
+        };
+
+    private:
+        struct Entry
+        {
+            ui32 format;
+            vector<ui8> data;
+        };
+
+        std::unordered_map<ui64, Entry> _entries{};
+        FilePath _path{};
+        ui64 _driverHash = 0;
+        bool _isEnabled = false;
+        bool _isModified = false;
+
+    public:
+        ProgramBinaryCache() = default; // disabled cache, never finds anything and never saves
+        ProgramBinaryCache(const FilePath &path, string_view driverId);
+
+        [[nodiscard]] bool IsEnabled() const;
+        [[nodiscard]] ui64 Key(string_view vsCode, string_view psCode) const;
+        [[nodiscard]] optional<Binary> Find(ui64 key) const;
+        void Store(ui64 key, ui32 format, vector<ui8> &&data);
+        void Remove(ui64 key);
+        [[nodiscard]] uiw Size() const;
+        bool Save(); // does nothing if there were no changes since the cache has been loaded or saved
+
+        // the cache's file contents, exposed to allow checking the format without a file
+        [[nodiscard]] vector<ui8> Serialize() const;
+        bool Deserialize(const ui8 *data, uiw size); // returns false and leaves the cache empty if the data is malformed or belongs to another driver
+    };
+}
\ No newline at end of file
@@ -11,19 +11,174 @@ using namespace OGLRenderer;
 static auto AcquireSetMatrixUniformFunction(const Shader::Uniform &shaderUniform) -> optional<ShaderBackendData::SetMatrixUniformFunction>;
 static auto AcquireSetUniformFunction(const Shader::Uniform &shaderUniform) -> optional<ShaderBackendData::SetUniformFunction>;
 
+namespace
+{
+	// returns 0 and logs the error if the shader failed to compile
+	GLuint CheckCompiledShader(GLuint shader, string_view stageName, string_view shaderName)
+	{
+		GLint status = 0;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+		if (status != GL_TRUE)
+		{
+			GLint infoLen = 0;
+			glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLen);
+			if (infoLen > 0)
+			{
+				string textError(infoLen, '\0');
+				glGetShaderInfoLog(shader, infoLen, 0, textError.data());
+				SENDLOG(Error, "Failed to compile a %*s shader for %*s, error %s\n", SVIEWARG(stageName), SVIEWARG(shaderName), textError.c_str());
+			}
+			else
+			{
+				SENDLOG(Error, "Failed to compile a %*s shader for %*s\n", SVIEWARG(stageName), SVIEWARG(shaderName));
+			}
+
+			glDeleteShader(shader);
+			return 0;
+		}
+
+		return shader;
+	}
+
+	GLuint BeginShaderStage(GLenum type, string_view code)
+	{
+		GLuint shader = glCreateShader(type);
+
+		const char *codes[1] = { code.data() };
+		GLint lengths[1] = { (GLint)code.size() };
+
+		glShaderSource(shader, 1, codes, lengths);
+		glCompileShader(shader);
+		return shader;
+	}
+
+	// statuses aren't queried here, so the driver is free to compile and link in the background
+	void BeginSourceCompilation(const Shader &shader, ShaderBackendData &backendData, bool isRetrievable)
+	{
+		backendData.pendingShaders[0] = BeginShaderStage(GL_VERTEX_SHADER, shader.VSCode());
+		backendData.pendingShaders[1] = BeginShaderStage(GL_FRAGMENT_SHADER, shader.PSCode());
+
+		backendData.pendingProgram = glCreateProgram();
+		if (isRetrievable)
+		{
+			glProgramParameteri(backendData.pendingProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
+		glAttachShader(backendData.pendingProgram, backendData.pendingShaders[0]);
+		glAttachShader(backendData.pendingProgram, backendData.pendingShaders[1]);
+		glLinkProgram(backendData.pendingProgram);
+		backendData.isPendingFromBinary = false;
+	}
+
+	// returns -1 if the uniform isn't a member of a uniform block
+	GLint UniformBlockMemberOffset(GLuint program, const char *name)
+	{
+		GLuint index = GL_INVALID_INDEX;
+		glGetUniformIndices(program, 1, &name, &index);
+		if (index == GL_INVALID_INDEX)
+		{
+			return -1;
+		}
+
+		GLint blockIndex = -1;
+		glGetActiveUniformsiv(program, 1, &index, GL_UNIFORM_BLOCK_INDEX, &blockIndex);
+		if (blockIndex == -1)
+		{
+			return -1;
+		}
+
+		GLint offset = -1;
+		glGetActiveUniformsiv(program, 1, &index, GL_UNIFORM_OFFSET, &offset);
+		return offset;
+	}
+}
+
 bool OpenGLRendererProxy::CheckShaderBackendData(const Shader &shader)
+{
+	auto *backendData = RendererBackendData<ShaderBackendData>(shader);
+	if (backendData == nullptr || RendererFrontendDataDirtyState(shader))
+	{
+		if (BeginShaderCompilation(shader) == false)
+		{
+			return true;
+		}
+	}
+	else if (backendData->pendingProgram == 0)
+	{
+		return false;
+	}
+
+	FinishShaderCompilation(shader);
+	return true;
+}
+
+bool OpenGLRendererProxy::BeginShaderCompilation(const Shader &shader)
 {
 	if (RendererBackendData(shader) == nullptr)
 	{
         AllocateBackendData<ShaderBackendData>(shader);
 	}
-    else if (RendererFrontendDataDirtyState(shader) == false)
-    {
-        return false;
-    }
 
 	RendererFrontendDataDirtyState(shader, false);
 
+	HasGLErrors();
+
+	auto &backendData = *RendererBackendData<ShaderBackendData>(shader);
+	backendData.DeletePending();
+
+	backendData.binaryKey = _programBinaryCache.Key(shader.VSCode(), shader.PSCode());
+	if (auto binary = _programBinaryCache.Find(backendData.binaryKey))
+	{
+		backendData.pendingProgram = glCreateProgram();
+		glProgramBinary(backendData.pendingProgram, (GLenum)binary->format, binary->data.data(), (GLsizei)binary->data.size());
+		backendData.isPendingFromBinary = true;
+	}
+	else
+	{
+		BeginSourceCompilation(shader, backendData, _programBinaryCache.IsEnabled());
+	}
+
+	if (HasGLErrors())
+	{
+		SENDLOG(Error, "Encountered OpenGL errors while starting compilation of shader %*s\n", SVIEWARG(shader.Name()));
+		SOFTBREAK;
+		DeleteBackendData(shader);
+		return false;
+	}
+
+	return true;
+}
+
+bool OpenGLRendererProxy::IsShaderCompilationComplete(const Shader &shader)
+{
+	const auto *backendData = RendererBackendData<ShaderBackendData>(shader);
+	if (backendData == nullptr || backendData->pendingProgram == 0)
+	{
+		return true;
+	}
+
+	if (!GLEW_ARB_parallel_shader_compile)
+	{
+		return true; // nothing to poll, finishing will block
+	}
+
+	GLint isComplete = GL_FALSE;
+	glGetProgramiv(backendData->pendingProgram, GL_COMPLETION_STATUS_ARB, &isComplete);
+	return isComplete == GL_TRUE;
+}
+
+bool OpenGLRendererProxy::FinishShaderCompilation(const Shader &shader)
+{
+	if (RendererBackendData(shader) == nullptr)
+	{
+		return false;
+	}
+
+	auto &backendData = *RendererBackendData<ShaderBackendData>(shader);
+	if (backendData.pendingProgram == 0)
+	{
+		return backendData.program != 0;
+	}
+
 	GLuint program = 0;
 
 	auto failedReturn = [&]()
@@ -31,97 +186,81 @@ bool OpenGLRendererProxy::CheckShaderBackendData(const Shader &shader)
 		SOFTBREAK;
 		glDeleteProgram(program);
         DeleteBackendData(shader);
-        return true;
+        return false;
 	};
 
-	HasGLErrors();
-
-	auto &backendData = *RendererBackendData<ShaderBackendData>(shader);
+	GLint status = 0;
 
-	auto loadShader = [](GLenum type, string_view code) -> GLuint
+	if (backendData.isPendingFromBinary)
 	{
-		GLuint shader = glCreateShader(type);
+		glGetProgramiv(backendData.pendingProgram, GL_LINK_STATUS, &status);
+		if (status != GL_TRUE || HasGLErrors())
+		{
+			// the driver is allowed to reject binaries it has produced, e.g. after its settings changed
+			SENDLOG(Info, "Cached program binary for shader %*s was rejected, compiling it from source\n", SVIEWARG(shader.Name()));
+			backendData.DeletePending();
+			_programBinaryCache.Remove(backendData.binaryKey);
+			BeginSourceCompilation(shader, backendData, _programBinaryCache.IsEnabled());
+		}
+	}
 
-		const char *codes[1] = { code.data() };
-		GLint lengths[1] = { (GLint)code.size() };
+	program = backendData.pendingProgram;
+	backendData.pendingProgram = 0;
 
-		glShaderSource(shader, 1, codes, lengths );
-		glCompileShader(shader);
+	if (backendData.isPendingFromBinary == false)
+	{
+		GLuint vs = CheckCompiledShader(backendData.pendingShaders[0], "vertex", shader.Name());
+		GLuint ps = CheckCompiledShader(backendData.pendingShaders[1], "pixel", shader.Name());
+		glDeleteShader(vs);
+		glDeleteShader(ps);
+		backendData.pendingShaders[0] = backendData.pendingShaders[1] = 0;
+		if (vs == 0 || ps == 0)
+		{
+			return failedReturn();
+		}
 
-		GLint status = 0;
-		glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
 		if (status != GL_TRUE)
 		{
 			GLint infoLen = 0;
-			glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLen);
+			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLen);
 			if (infoLen > 0)
 			{
 				string textError(infoLen, '\0');
-				glGetShaderInfoLog(shader, infoLen, 0, textError.data());
-				SENDLOG(Error, "Failed to compile a shader, error %s\n", textError.c_str());
+				glGetProgramInfoLog(program, infoLen, 0, textError.data());
+				SENDLOG(Error, "Failed to compile shader %*s, error %s\n", SVIEWARG(shader.Name()), textError.data());
+			}
+			else
+			{
+				SENDLOG(Error, "Failed to compile shader %*s\n", SVIEWARG(shader.Name()));
 			}
 
-			glDeleteShader(shader);
-			HasGLErrors();
-			return 0;
+			return failedReturn();
 		}
 
 		if (HasGLErrors())
 		{
-			SENDLOG(Error, "Encountered OpenGL errors while compiling a shader\n");
-			glDeleteShader(shader);
-			return 0;
+			SENDLOG(Error, "Failed to compile shader %*s\n", SVIEWARG(shader.Name()));
+			return failedReturn();
 		}
 
-		SENDLOG(Info, "Compiled a new shader\n");
-		return shader;
-	};
-
-	auto vs = loadShader(GL_VERTEX_SHADER, shader.VSCode());
-	if (vs == 0)
-	{
-		SENDLOG(Error, "Failed to compile a vertex shader for %*s\n", SVIEWARG(shader.Name()));
-		return failedReturn();
-	}
-
-	auto ps = loadShader(GL_FRAGMENT_SHADER, shader.PSCode());
-	if (ps == 0)
-	{
-		SENDLOG(Error, "Failed to compile a pixel shader for %*s\n", SVIEWARG(shader.Name()));
-		return failedReturn();
-	}
-
-	program = glCreateProgram();
-	glAttachShader(program, vs);
-	glAttachShader(program, ps);
-	glLinkProgram(program);
-	glDeleteShader(vs);
-	glDeleteShader(ps);
-
-	GLint status = 0;
-	glGetProgramiv(program, GL_LINK_STATUS, &status);
-	if (status != GL_TRUE)
-	{		
-		GLint infoLen = 0;
-		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLen);
-		if (infoLen > 0)
-		{
-			string textError(infoLen, '\0');
-			glGetProgramInfoLog(program, infoLen, 0, textError.data());
-			SENDLOG(Error, "Failed to compile shader %*s, error %s\n", SVIEWARG(shader.Name()), textError.data());
-		}
-		else
+		if (_programBinaryCache.IsEnabled())
 		{
-			SENDLOG(Error, "Failed to compile shader %*s\n", SVIEWARG(shader.Name()));
+			GLint binaryLength = 0;
+			glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+			if (binaryLength > 0)
+			{
+				vector<ui8> binary(binaryLength);
+				GLenum binaryFormat = 0;
+				glGetProgramBinary(program, binaryLength, nullptr, &binaryFormat, binary.data());
+				if (HasGLErrors() == false)
+				{
+					_programBinaryCache.Store(backendData.binaryKey, binaryFormat, move(binary));
+				}
+			}
 		}
 
-		return failedReturn();
-	}
-
-	if (HasGLErrors())
-	{
-		SENDLOG(Error, "Failed to compile shader %*s\n", SVIEWARG(shader.Name()));
-		return failedReturn();
+		SENDLOG(Info, "Compiled shader %*s\n", SVIEWARG(shader.Name()));
 	}
 
     auto getOglUniformsInfo = [&shader, &program](const vector<Shader::Uniform> &uniforms, unique_ptr<ShaderBackendData::OGLUniform[]> &oglUniforms) -> bool
@@ -139,6 +278,12 @@ bool OpenGLRendererProxy::CheckShaderBackendData(const Shader &shader)
 
             string nullTerminatedName = string(uniform.name.data(), uniform.name.data() + uniform.name.size());
             GLint location = glGetUniformLocation(program, nullTerminatedName.c_str());
+            if (location == -1 && UniformBlockMemberOffset(program, nullTerminatedName.c_str()) != -1)
+            {
+                // it's set through its uniform block, see UniformBlocks
+                oglUniforms[uniformIndex] = {-1, 0};
+                continue;
+            }
             if (location == -1)
             {
                 SENDLOG(Warning, "Failed to locate uniform %s in shader %*s\n", nullTerminatedName.c_str(), SVIEWARG(shader.Name()));
@@ -175,12 +320,68 @@ bool OpenGLRendererProxy::CheckShaderBackendData(const Shader &shader)
         SENDLOG(Error, "Error has occured while resolving uniforms for shader %*s\n", SVIEWARG(shader.Name()));
         return failedReturn();
     }
-    if (false == getOglUniformsInfo(shader.SystemUniforms(), backendData.systemOglUniforms))
+    unique_ptr<ShaderBackendData::OGLUniform[]> systemOglUniforms;
+    if (false == getOglUniformsInfo(shader.SystemUniforms(), systemOglUniforms))
     {
         SENDLOG(Error, "Error has occured while resolving uniforms for shader %*s\n", SVIEWARG(shader.Name()));
         return failedReturn();
     }
 
+    backendData.systemOglUniforms = {};
+    for (uiw uniformIndex = 0; uniformIndex < shader.SystemUniforms().size(); ++uniformIndex)
+    {
+        auto slot = Shader::FindSystemUniformSlot(shader.SystemUniforms()[uniformIndex].name);
+        if (!slot)
+        {
+            SENDLOG(Warning, "Shader %*s has unknown system uniform %*s, it'll never be set\n", SVIEWARG(shader.Name()), SVIEWARG(shader.SystemUniforms()[uniformIndex].name));
+            continue;
+        }
+        backendData.systemOglUniforms[(uiw)*slot] = systemOglUniforms[uniformIndex];
+    }
+
+    backendData.materialBlockSize = 0;
+    GLuint materialBlockIndex = glGetUniformBlockIndex(program, UniformBlocks::MaterialName);
+    if (materialBlockIndex != GL_INVALID_INDEX)
+    {
+        glUniformBlockBinding(program, materialBlockIndex, UniformBlocks::MaterialBinding);
+
+        // the block's data is laid out on the CPU, so the declaration must match it exactly
+        ui32 blockOffset = 0;
+        for (const auto &uniform : shader.Uniforms())
+        {
+            if (uniform.type == Shader::Uniform::Type::Texture)
+            {
+                continue;
+            }
+
+            blockOffset = UniformBlocks::Std140Align(blockOffset, uniform);
+            string nullTerminatedName = string(uniform.name.data(), uniform.name.data() + uniform.name.size());
+            if (UniformBlockMemberOffset(program, nullTerminatedName.c_str()) != (GLint)blockOffset)
+            {
+                SENDLOG(Error, "Uniform %*s of shader %*s must be a member of %s at std140 offset %u\n", SVIEWARG(uniform.name), SVIEWARG(shader.Name()), UniformBlocks::MaterialName, blockOffset);
+                return failedReturn();
+            }
+            blockOffset += UniformBlocks::Std140Size(uniform);
+        }
+
+        GLint blockSize = 0;
+        glGetActiveUniformBlockiv(program, materialBlockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &blockSize);
+        backendData.materialBlockSize = std::max((ui32)blockSize, blockOffset);
+    }
+
+    GLuint cameraBlockIndex = glGetUniformBlockIndex(program, UniformBlocks::CameraName);
+    if (cameraBlockIndex != GL_INVALID_INDEX)
+    {
+        GLint blockSize = 0;
+        glGetActiveUniformBlockiv(program, cameraBlockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &blockSize);
+        if (blockSize != sizeof(UniformBlocks::CameraData))
+        {
+            SENDLOG(Error, "%s of shader %*s has size %i, but %u is expected\n", UniformBlocks::CameraName, SVIEWARG(shader.Name()), blockSize, (ui32)sizeof(UniformBlocks::CameraData));
+            return failedReturn();
+        }
+        glUniformBlockBinding(program, cameraBlockIndex, UniformBlocks::CameraBinding);
+    }
+
     auto attributesCount = shader.InputAttributes().size();
 
     if (backendData.attributeLocations == nullptr && attributesCount > 0)
@@ -201,6 +402,7 @@ bool OpenGLRendererProxy::CheckShaderBackendData(const Shader &shader)
         backendData.attributeLocations[attributeIndex] = location;
     }
 
+	glDeleteProgram(backendData.program);
 	backendData.program = program;
 
     return true;
@@ -0,0 +1,121 @@
+#include "BasicHeader.hpp"
+#include "ShaderCompileQueue.hpp"
+#include <Shader.hpp>
+#include <Logger.hpp>
+
+using namespace EngineCore;
+using namespace OGLRenderer;
+
+ShaderCompileQueue::ShaderCompileQueue(Backend &backend, ui32 maxStartedPerUpdate) : _backend(backend), _maxStartedPerUpdate(maxStartedPerUpdate)
+{
+    ASSUME(maxStartedPerUpdate > 0);
+}
+
+void ShaderCompileQueue::Enqueue(const shared_ptr<const Shader> &shader)
+{
+    ASSUME(shader != nullptr);
+    if (_queued.insert(shader.get()).second)
+    {
+        _waiting.push_back(shader);
+    }
+}
+
+bool ShaderCompileQueue::IsQueued(const Shader &shader) const
+{
+    return _queued.find(&shader) != _queued.end();
+}
+
+uiw ShaderCompileQueue::QueuedCount() const
+{
+    return _queued.size();
+}
+
+ui32 ShaderCompileQueue::FailedCount() const
+{
+    return _failedCount;
+}
+
+void ShaderCompileQueue::Update()
+{
+    // polled before starting new ones, so there's at least a frame between starting a compilation and checking it
+    for (uiw index = 0; index < _compiling.size(); )
+    {
+        if (_backend.IsCompilationComplete(*_compiling[index]))
+        {
+            Finish(_compiling[index]);
+            _compiling[index] = move(_compiling.back());
+            _compiling.pop_back();
+        }
+        else
+        {
+            ++index;
+        }
+    }
+
+    for (ui32 started = 0; started < _maxStartedPerUpdate && _waiting.size(); ++started)
+    {
+        auto shader = move(_waiting.front());
+        _waiting.pop_front();
+
+        if (_backend.BeginCompilation(*shader))
+        {
+            _compiling.push_back(move(shader));
+        }
+        else
+        {
+            ++_failedCount;
+            _queued.erase(shader.get());
+        }
+    }
+}
+
+void ShaderCompileQueue::Flush()
+{
+    while (_waiting.size())
+    {
+        auto shader = move(_waiting.front());
+        _waiting.pop_front();
+
+        if (_backend.BeginCompilation(*shader))
+        {
+            _compiling.push_back(move(shader));
+        }
+        else
+        {
+            ++_failedCount;
+            _queued.erase(shader.get());
+        }
+    }
+
+    for (const auto &shader : _compiling)
+    {
+        Finish(shader);
+    }
+    _compiling.clear();
+    ASSUME(_queued.empty());
+}
+
+void ShaderCompileQueue::Clear()
+{
+    for (const auto &shader : _waiting)
+    {
+        _queued.erase(shader.get());
+    }
+    _waiting.clear();
+
+    for (const auto &shader : _compiling)
+    {
+        Finish(shader);
+    }
+    _compiling.clear();
+}
+
+void ShaderCompileQueue::Finish(const shared_ptr<const Shader> &shader)
+{
+    if (!_backend.FinishCompilation(*shader))
+    {
+        SENDLOG(Error, "ShaderCompileQueue failed to compile shader %*s\n", SVIEWARG(shader->Name()));
+        ++_failedCount;
+    }
+    _queued.erase(shader.get());
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <deque>
+#include <unordered_set>
+
+namespace EngineCore
+{
+    class Shader;
+}
+
+namespace OGLRenderer
+{
+    // spreads shader compilation over several frames, a compilation is started, then polled without blocking, and finished once it's complete
+    // the actual work is done by the Backend, so the scheduling doesn't depend on OpenGL
+    class ShaderCompileQueue
+    {
+    public:
+        struct Backend
+        {
+            virtual ~Backend() = default;
+            virtual bool BeginCompilation(const EngineCore::Shader &shader) = 0; // returns false if the compilation couldn't be started
+            virtual bool IsCompilationComplete(const EngineCore::Shader &shader) = 0; // mustn't block
+            virtual bool FinishCompilation(const EngineCore::Shader &shader) = 0; // may block if the compilation isn't complete, returns false if it failed
+        };
+
+    private:
+        Backend &_backend;
+        std::deque<shared_ptr<const EngineCore::Shader>> _waiting{};
+        vector<shared_ptr<const EngineCore::Shader>> _compiling{};
+        std::unordered_set<const EngineCore::Shader *> _queued{};
+        ui32 _maxStartedPerUpdate = 0;
+        ui32 _failedCount = 0;
+
+    public:
+        ShaderCompileQueue(Backend &backend, ui32 maxStartedPerUpdate = 4);
+
+        void Enqueue(const shared_ptr<const EngineCore::Shader> &shader); // does nothing if the shader is already queued
+        [[nodiscard]] bool IsQueued(const EngineCore::Shader &shader) const;
+        [[nodiscard]] uiw QueuedCount() const;
+        [[nodiscard]] ui32 FailedCount() const;
+
+        void Update(); // finishes complete compilations and starts up to maxStartedPerUpdate new ones
+        void Flush(); // starts and finishes everything, blocks until done
+        void Clear(); // drops queued shaders, compilations that have already started are finished
+
+    private:
+        void Finish(const shared_ptr<const EngineCore::Shader> &shader);
+    };
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "BasicHeader.hpp"
+#include "StagingAllocator.hpp"
+
+using namespace EngineCore;
+using namespace OGLRenderer;
+
+ui8 *StagingAllocator::Acquire(ui32 size)
+{
+    Block *best = nullptr;
+    for (auto &block : _blocks)
+    {
+        if (!block.isInUse && block.size >= size && (best == nullptr || block.size < best->size))
+        {
+            best = &block;
+        }
+    }
+
+    if (best == nullptr)
+    {
+        best = &_blocks.emplace_back(Block{make_unique<ui8[]>(size), size, 0, false});
+    }
+
+    best->isInUse = true;
+    best->idleFrames = 0;
+    return best->memory.get();
+}
+
+void StagingAllocator::Release(ui8 *memory)
+{
+    for (auto &block : _blocks)
+    {
+        if (block.memory.get() == memory)
+        {
+            ASSUME(block.isInUse);
+            block.isInUse = false;
+            return;
+        }
+    }
+
+    UNREACHABLE;
+}
+
+void StagingAllocator::EndFrame()
+{
+    for (uiw index = 0; index < _blocks.size(); )
+    {
+        auto &block = _blocks[index];
+        if (!block.isInUse && ++block.idleFrames >= IdleFramesBeforeRelease)
+        {
+            block = move(_blocks.back());
+            _blocks.pop_back();
+        }
+        else
+        {
+            ++index;
+        }
+    }
+}
+
+uiw StagingAllocator::AllocatedBytes() const
+{
+    uiw bytes = 0;
+    for (const auto &block : _blocks)
+    {
+        bytes += block.size;
+    }
+    return bytes;
+}
\ No newline at end of file
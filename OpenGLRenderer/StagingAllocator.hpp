@@ -0,0 +1,27 @@
+#pragma once
+
+namespace OGLRenderer
+{
+    // transient CPU memory for write-only locks of arrays that don't keep a shadow copy
+    // blocks are reused between locks and freed once they haven't been used for a while
+    class StagingAllocator
+    {
+        struct Block
+        {
+            unique_ptr<ui8[]> memory;
+            ui32 size;
+            ui32 idleFrames;
+            bool isInUse;
+        };
+
+        vector<Block> _blocks{};
+
+    public:
+        static constexpr ui32 IdleFramesBeforeRelease = 8;
+
+        [[nodiscard]] ui8 *Acquire(ui32 size);
+        void Release(ui8 *memory);
+        void EndFrame(); // frees blocks that have been idle for IdleFramesBeforeRelease frames
+        [[nodiscard]] uiw AllocatedBytes() const;
+    };
+}
\ No newline at end of file
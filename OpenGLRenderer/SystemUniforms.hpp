@@ -0,0 +1,50 @@
+#pragma once
+
+// Shader.hpp must be included first, the header is shared with EngineCore, which has only this directory among its include paths
+
+namespace OGLRenderer
+{
+    // camera dependent system uniforms, recomputed and uploaded only when the camera changes, so usually once per camera per frame
+    struct CameraConstants
+    {
+        optional<Vector3> position{};
+        optional<Matrix4x3> viewMatrix{};
+        optional<Matrix4x4> projMatrix{};
+        Matrix4x4 viewProjMatrix{};
+        Vector3 forwardVector{}, rightVector{}, upVector{};
+    };
+
+    // the per-draw part of the system uniforms, the shader's table is indexed by Shader::SystemUniformSlot, an entry has location and setFuncAddress, which is 0 if the shader doesn't have the uniform
+    // the uniform functions are only called through the table, so the setup doesn't depend on OpenGL, the system_uniforms headless benchmark runs it with stubbed functions
+    template <typename SetMatrixUniformFunction, typename SetUniformFunction, typename OGLUniform> void SetSystemUniforms(const array<OGLUniform, (uiw)EngineCore::Shader::SystemUniformSlot::_size> &systemOglUniforms, const CameraConstants &cameraConstants, const Matrix4x3 *modelMatrix)
+    {
+        using EngineCore::Shader;
+
+        auto setMatrix = [&systemOglUniforms](Shader::SystemUniformSlot slot, const auto &matrix)
+        {
+            const auto &oglUniform = systemOglUniforms[(uiw)slot];
+            if (oglUniform.setFuncAddress)
+            {
+                reinterpret_cast<SetMatrixUniformFunction>(oglUniform.setFuncAddress)(oglUniform.location, 1, false, matrix.Data().data());
+            }
+        };
+
+        auto setFloats = [&systemOglUniforms](Shader::SystemUniformSlot slot, const auto &values)
+        {
+            const auto &oglUniform = systemOglUniforms[(uiw)slot];
+            if (oglUniform.setFuncAddress)
+            {
+                reinterpret_cast<SetUniformFunction>(oglUniform.setFuncAddress)(oglUniform.location, 1, values.Data().data());
+            }
+        };
+
+        setMatrix(Shader::SystemUniformSlot::ModelMatrix, modelMatrix ? *modelMatrix : Matrix4x3{});
+        setMatrix(Shader::SystemUniformSlot::ViewMatrix, cameraConstants.viewMatrix.value_or(Matrix4x3{}));
+        setMatrix(Shader::SystemUniformSlot::ProjectionMatrix, cameraConstants.projMatrix.value_or(Matrix4x4{}));
+        setMatrix(Shader::SystemUniformSlot::ViewProjectionMatrix, cameraConstants.viewProjMatrix);
+        setFloats(Shader::SystemUniformSlot::CameraPosition, cameraConstants.position.value_or(Vector3{}));
+        setFloats(Shader::SystemUniformSlot::CameraForwardVector, cameraConstants.forwardVector);
+        setFloats(Shader::SystemUniformSlot::CameraRightVector, cameraConstants.rightVector);
+        setFloats(Shader::SystemUniformSlot::CameraUpVector, cameraConstants.upVector);
+    }
+}
\ No newline at end of file
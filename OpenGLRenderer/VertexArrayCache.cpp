@@ -0,0 +1,92 @@
+#include "BasicHeader.hpp"
+#include "VertexArrayCache.hpp"
+
+using namespace EngineCore;
+using namespace OGLRenderer;
+
+bool VertexArrayCache::Key::operator == (const Key &other) const
+{
+    return layoutId == other.layoutId && bufferIds == other.bufferIds;
+}
+
+size_t VertexArrayCache::KeyHasher::operator()(const Key &key) const
+{
+    size_t hash = std::hash<ui64>()(key.layoutId);
+    for (ui64 bufferId : key.bufferIds)
+    {
+        hash ^= std::hash<ui64>()(bufferId) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+VertexArrayCache::VertexArrayCache(uiw capacity) : _capacity(capacity)
+{
+    ASSUME(capacity > 0);
+}
+
+VertexArrayCache::~VertexArrayCache()
+{
+    ASSUME(_entries.empty()); // Clear must be called before the context is destroyed
+}
+
+GLuint VertexArrayCache::Find(const Key &key)
+{
+    auto searchResult = _lookup.find(key);
+    if (searchResult == _lookup.end())
+    {
+        return 0;
+    }
+    _entries.splice(_entries.begin(), _entries, searchResult->second);
+    return searchResult->second->second;
+}
+
+void VertexArrayCache::Insert(const Key &key, GLuint vertexArray)
+{
+    ASSUME(_lookup.find(key) == _lookup.end());
+
+    if (_entries.size() == _capacity)
+    {
+        glDeleteVertexArrays(1, &_entries.back().second);
+        _lookup.erase(_entries.back().first);
+        _entries.pop_back();
+    }
+
+    _entries.emplace_front(key, vertexArray);
+    _lookup[key] = _entries.begin();
+}
+
+void VertexArrayCache::EvictBuffers(ui64 firstBufferId, ui64 lastBufferId)
+{
+    for (auto it = _entries.begin(); it != _entries.end(); )
+    {
+        bool isUsingBuffers = std::any_of(it->first.bufferIds.begin(), it->first.bufferIds.end(), [firstBufferId, lastBufferId](ui64 bufferId)
+        {
+            return bufferId >= firstBufferId && bufferId <= lastBufferId;
+        });
+        if (isUsingBuffers)
+        {
+            glDeleteVertexArrays(1, &it->second);
+            _lookup.erase(it->first);
+            it = _entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void VertexArrayCache::Clear()
+{
+    for (auto &[key, vertexArray] : _entries)
+    {
+        glDeleteVertexArrays(1, &vertexArray);
+    }
+    _entries.clear();
+    _lookup.clear();
+}
+
+uiw VertexArrayCache::Size() const
+{
+    return _entries.size();
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+namespace OGLRenderer
+{
+    // vertex array objects keyed by a resolved vertex layout and the vertex buffers it reads from
+    // ids in the key are never reused unlike GL names, so entries that refer to deleted layouts are never found again and get evicted eventually
+    // entries that refer to deleted or recreated buffers must be evicted explicitly, a vertex array object keeps its buffers' storage alive
+    // when the cache is full the least recently used vertex array object is deleted
+    class VertexArrayCache
+    {
+    public:
+        static constexpr uiw VertexArraysLimit = 8;
+
+        struct Key
+        {
+            ui64 layoutId = 0;
+            array<ui64, VertexArraysLimit> bufferIds{}; // 0 for vertex arrays the layout doesn't use
+
+            bool operator == (const Key &other) const;
+        };
+
+    private:
+        struct KeyHasher
+        {
+            size_t operator()(const Key &key) const;
+        };
+
+        using Entries = std::list<pair<Key, GLuint>>;
+
+        Entries _entries{}; // the most recently used is the first
+        std::unordered_map<Key, Entries::iterator, KeyHasher> _lookup{};
+        uiw _capacity = 0;
+
+    public:
+        VertexArrayCache(uiw capacity = 256);
+        ~VertexArrayCache();
+
+        VertexArrayCache(VertexArrayCache &&) = delete;
+        VertexArrayCache &operator = (VertexArrayCache &&) = delete;
+
+        [[nodiscard]] GLuint Find(const Key &key); // returns 0 if there's no such vertex array object
+        void Insert(const Key &key, GLuint vertexArray); // the cache takes the ownership
+        void EvictBuffers(ui64 firstBufferId, ui64 lastBufferId); // deletes vertex array objects that use any buffer id from the inclusive range
+        void Clear(); // must be called while the context is current
+        [[nodiscard]] uiw Size() const;
+    };
+}
\ No newline at end of file
@@ -4,9 +4,11 @@
 #include <Logger.hpp>
 #include <RendererArray.hpp>
 #include <Material.hpp>
+#include <ShadersManager.hpp>
 #include <VertexLayout.hpp>
 #include <RendererPipelineState.hpp>
 #include <Renderer.hpp>
+#include <RendererDrawQueue.hpp>
 
 using namespace EngineCore;
 using namespace TradingApp;
@@ -53,10 +55,11 @@ CubesInstanced::CubesInstanced(ui32 maxInstances, bool isProceduralGeometry)
 	}
 	else
 	{
-		auto shader = Application::LoadResource<Shader>("Colored3DVerticesInstanced");
+		constexpr ShaderVariantKey instancedKey = BuiltinShaderKeywords::Colored3DVertices.Key("INSTANCED");
+		auto shader = Shader::Variant(Application::LoadResource<Shader>("Colored3DVertices"), instancedKey);
 		if (shader == nullptr)
 		{
-			SENDLOG(Error, "Cube failed to load shader Colored3DVerticesInstanced\n");
+			SENDLOG(Error, "Cube failed to load shader Colored3DVertices+INSTANCED\n");
 			return;
 		}
 
@@ -176,22 +179,29 @@ void CubesInstanced::Unlock()
     _vertexInstanceArray->UnlockDataRegion();
 }
 
-void CubesInstanced::Draw(const Camera *camera, ui32 instancesCount)
+void CubesInstanced::Draw(const Camera *camera, ui32 instancesCount, RendererDrawQueue &queue, ui8 layer)
 {
 	ASSUME(instancesCount <= MaxInstances());
 
+	RendererDrawQueue::DrawDesc draw;
+	draw.camera = camera;
+	draw.pipelineState = _pipelineState.get();
+	draw.material = _material.get();
+	draw.instanceCount = instancesCount;
+	draw.layer = layer;
+
 	if (_indexArray)
 	{
-		Application::GetRenderer().BindIndexArray(_indexArray);
-		Application::GetRenderer().BindVertexArray(_vertexArray, 0);
-		Application::GetRenderer().BindVertexArray(_vertexInstanceArray, 1);
-
-		Application::GetRenderer().DrawIndexedWithCamera(camera, nullptr, _pipelineState.get(), _material.get(), PrimitiveTopology::TriangleEnumeration, _indexArray->NumberOfElements(), instancesCount);
+		draw.vertexArrays[0] = _vertexArray;
+		draw.vertexArrays[1] = _vertexInstanceArray;
+		draw.indexArray = _indexArray;
+		draw.count = _indexArray->NumberOfElements();
 	}
 	else
 	{
-		Application::GetRenderer().BindVertexArray(_vertexInstanceArray, 0);
-
-		Application::GetRenderer().DrawWithCamera(camera, nullptr, _pipelineState.get(), _material.get(), PrimitiveTopology::TriangleEnumeration, 18, instancesCount);
+		draw.vertexArrays[0] = _vertexInstanceArray;
+		draw.count = 18;
 	}
+
+	queue.Add(move(draw));
 }
@@ -7,6 +7,7 @@ namespace EngineCore
     class RendererVertexArray;
     class RendererIndexArray;
     class Camera;
+    class RendererDrawQueue;
 }
 
 #include <MatrixMathTypes.hpp>
@@ -33,6 +34,6 @@ namespace TradingApp
 		ui32 MaxInstances();
         InstanceData *Lock(ui32 instancesCount);
         void Unlock();
-        void Draw(const EngineCore::Camera *camera, ui32 instancesCount);
+        void Draw(const EngineCore::Camera *camera, ui32 instancesCount, EngineCore::RendererDrawQueue &queue, ui8 layer);
     };
 }
\ No newline at end of file
@@ -46,8 +46,6 @@ public:
 
 namespace
 {
-	static constexpr bool IsDefaultGPU = true;
-
 	static constexpr f32 ContactOffset = 0.0075f;
 	static constexpr f32 RestOffset = 0.0f;
 	static constexpr f32 SleepThreshold = 0.01f;
@@ -174,7 +172,7 @@ PhysXActorData &PhysXActorData::FromUserData(PxActor &actor)
 	return PhysXPlaneData;
 }
 
-bool PhysX::Create()
+bool PhysX::Create(bool isUseGPU)
 {
     assert(!IsInitialized);
 
@@ -223,7 +221,14 @@ bool PhysX::Create()
     sceneLimits.maxNbBodies = 10'000;
     sceneLimits.maxNbDynamicShapes = 10'000;
 
-    if (!SetSceneProcessing(sceneDesc, IsDefaultGPU ? ProcessingOn::GPU : ProcessingOn::CPU, IsDefaultGPU ? BroadPhaseType::GPU : BroadPhaseType::SAP))
+    bool isSceneProcessingSet = SetSceneProcessing(sceneDesc, isUseGPU ? ProcessingOn::GPU : ProcessingOn::CPU, isUseGPU ? BroadPhaseType::GPU : BroadPhaseType::SAP);
+    if (!isSceneProcessingSet && isUseGPU)
+    {
+        // machines without a CUDA capable device still run the simulation
+        SENDLOG(Warning, "PhysX::Create -> GPU simulation isn't available, falling back to CPU\n");
+        isSceneProcessingSet = SetSceneProcessing(sceneDesc, ProcessingOn::CPU, BroadPhaseType::SAP);
+    }
+    if (!isSceneProcessingSet)
     {
         SENDLOG(Error, "PhysX::Create -> SetSceneProcessing failed\n");
         return false;
@@ -367,14 +372,14 @@ void PhysX::Update()
     PhysXScene->simulate(Application::GetEngineTime().secondSinceLastFrame, nullptr, SimulationMemory.get(), SimulationMemorySize);
 }
 
-void PhysX::Draw(const Camera &camera)
+void PhysX::Draw(const Camera &camera, RendererDrawQueue &queue, ui8 layer)
 {
     if (!IsInitialized)
     {
         return;
     }
 
-    auto genericDraw = [](const Camera &camera, const auto &source, const auto &instancedObject)
+    auto genericDraw = [&queue, layer](const Camera &camera, const auto &source, const auto &instancedObject)
     {
         if (source.size() && instancedObject)
         {
@@ -396,7 +401,7 @@ void PhysX::Draw(const Camera &camera)
                 ++lock;
             }
             instancedObject->Unlock();
-            instancedObject->Draw(&camera, (ui32)source.size());
+            instancedObject->Draw(&camera, (ui32)source.size(), queue, layer);
         }
     };
 
@@ -512,7 +517,7 @@ auto PhysX::GetNewContacts() -> pair<const ContactInfo *, uiw>
 
 bool SetSceneProcessing(PxSceneDesc &desc, ProcessingOn processingOn, BroadPhaseType broadPhaseType)
 {
-    if (processingOn == ProcessingOn::CPU || broadPhaseType == BroadPhaseType::SAP)
+    if (processingOn == ProcessingOn::GPU || broadPhaseType == BroadPhaseType::GPU)
     {
         /*PxU32 constraintBufferCapacity;	//!< Capacity of constraint buffer allocated in GPU global memory
         PxU32 contactBufferCapacity;	//!< Capacity of contact buffer allocated in GPU global memory
@@ -534,16 +539,19 @@ bool SetSceneProcessing(PxSceneDesc &desc, ProcessingOn processingOn, BroadPhase
         mc.foundLostPairsCapacity *= 3;
         desc.gpuDynamicsConfig = mc;
 
-        HGLRC hg = wglGetCurrentContext();
-
         PxCudaContextManagerDesc cudaContextManagerDesc;
         //cudaContextManagerDesc.interopMode = PxCudaInteropMode::OGL_INTEROP;
         //cudaContextManagerDesc.graphicsDevice = Application::GetRenderer().RendererContext();
-        //cudaContextManagerDesc.graphicsDevice = hg;
+        //cudaContextManagerDesc.graphicsDevice = wglGetCurrentContext();
         CudaContexManager = PxCreateCudaContextManager(*Foundation, cudaContextManagerDesc);
         if (!CudaContexManager || !CudaContexManager->contextIsValid())
         {
-            SENDLOG(Error, "PhysX::Create -> PxCreateCudaContextManager failed\n");
+            SENDLOG(Warning, "PhysX::Create -> PxCreateCudaContextManager failed\n");
+            if (CudaContexManager)
+            {
+                CudaContexManager->release();
+                CudaContexManager = nullptr;
+            }
             return false;
         }
         desc.cudaContextManager = CudaContexManager;
@@ -21,10 +21,10 @@ namespace TradingApp::PhysX
 		f32 size;
 	};
 
-    bool Create();
+    bool Create(bool isUseGPU); // CPU simulation doesn't require a CUDA capable device
     void Destroy();
     void Update();
-    void Draw(const EngineCore::Camera &camera);
+    void Draw(const EngineCore::Camera &camera, EngineCore::RendererDrawQueue &queue, ui8 layer);
 	void ClearObjects();
     void AddObjects(vector<ObjectData> &cubes, vector<ObjectData> &spheres);
     pair<const ContactInfo *, uiw> GetNewContacts();
@@ -12,6 +12,8 @@
 #include <Camera.hpp>
 #include "SoundCache.hpp"
 #include <IKeyController.hpp>
+#include <RendererDrawQueue.hpp>
+#include <Renderer.hpp>
 
 using namespace EngineCore;
 using namespace TradingApp;
@@ -78,13 +80,21 @@ namespace
 	};
 	AudioSourceInRun CollisionAudioSources[16]{};
 
-	TimeDifference SpawnTimeout{0.1_s};
-	TimeMoment LastSpawnedTime = TimeMoment::Earliest();
+	// engine time is used instead of the wall clock, so the spawning doesn't depend on the frame rate when input is replayed
+	static constexpr f64 SpawnTimeout = 0.1;
+	f64 LastSpawnedTime = std::numeric_limits<f64>::lowest();
+
+	// reused every frame to keep their memory, both are emptied after the submission, so they don't keep the arrays alive
+	RendererDrawQueue DrawQueue{};
+	RendererCommandBuffer DrawCommands{};
+
+	// the background is drawn first, as it was before the queue, and the objects over it
+	static constexpr ui8 BackgroundLayer = 0, ObjectsLayer = 1;
 }
 
-bool PhysicsScene::Create()
+bool PhysicsScene::Create(bool isHeadless)
 {
-	if (!PhysX::Create())
+	if (!PhysX::Create(!isHeadless))
 	{
 		return false;
 	}
@@ -95,13 +105,16 @@ bool PhysicsScene::Create()
 	}
 
 #ifdef USE_XAUDIO
-	AudioEngine = XAudioEngine::New();
-	if (!AudioEngine)
+	if (!isHeadless)
 	{
-		return false;
-	}
+		AudioEngine = XAudioEngine::New();
+		if (!AudioEngine)
+		{
+			return false;
+		}
 
-	//AddTestAudio();
+		//AddTestAudio();
+	}
 #endif
 
 	Restart();
@@ -128,7 +141,10 @@ void PhysicsScene::Update(Vector3 mainCameraPosition, Vector3 mainCameraRotation
 	SceneBackground::Update();
 
 #ifdef USE_XAUDIO
-	AudioEngine->Update();
+	if (AudioEngine)
+	{
+		AudioEngine->Update();
+	}
 #endif
 }
 
@@ -146,20 +162,36 @@ void PhysicsScene::Restart()
 	PhysX::AddObjects(Cubes, Spheres);
 }
 
-void PhysicsScene::Draw(const Camera &camera)
+auto PhysicsScene::Draw(const Camera &camera) -> DrawCounts
 {
-	PhysX::Draw(camera);
+	PhysX::Draw(camera, DrawQueue, ObjectsLayer);
+	SceneBackground::Draw({MathPi<f32>() * 0.5f, 0, 0}, camera, DrawQueue, BackgroundLayer);
+
+	DrawCounts counts;
+	counts.draws = (ui32)DrawQueue.Size();
+	counts.stateChangesUnsorted = RendererDrawQueue::CountStateChanges(DrawQueue.Entries());
+	DrawQueue.Sort();
+	counts.stateChangesSorted = RendererDrawQueue::CountStateChanges(DrawQueue.Entries());
+	counts.stateCommands = DrawQueue.WriteTo(DrawCommands);
 
-	SceneBackground::Draw({MathPi<f32>() * 0.5f, 0, 0}, camera);
+	const RendererCommandBuffer *buffers[] = {&DrawCommands};
+	Application::GetRenderer().SubmitCommandBuffers(buffers);
+	DrawCommands.Reset();
+	DrawQueue.Clear();
 
 #ifdef USE_XAUDIO
-	XAudioEngine::PositioningInfo positioning;
-	positioning.orientFront = camera.ForwardAxis();
-	positioning.orientTop = camera.UpAxis();
-	positioning.position = camera.Position();
-	positioning.velocity = {};
-	AudioEngine->SetListenerPositioning(positioning);
+	if (AudioEngine)
+	{
+		XAudioEngine::PositioningInfo positioning;
+		positioning.orientFront = camera.ForwardAxis();
+		positioning.orientTop = camera.UpAxis();
+		positioning.position = camera.Position();
+		positioning.velocity = {};
+		AudioEngine->SetListenerPositioning(positioning);
+	}
 #endif
+
+	return counts;
 }
 
 void PlaceSparse()
@@ -421,7 +453,7 @@ void ProcessControls(Vector3 mainCameraPosition, Vector3 mainCameraRotation)
 		return;
 	}
 
-	TimeMoment current = TimeMoment::Now();
+	f64 current = Application::GetEngineTime().secondsSinceStart;
 	if (current < LastSpawnedTime + SpawnTimeout)
 	{
 		return;
@@ -9,10 +9,17 @@ namespace TradingApp
 {
     namespace PhysicsScene
     {
-        bool Create();
+        struct DrawCounts
+        {
+            ui32 draws = 0;
+            ui32 stateChangesUnsorted = 0, stateChangesSorted = 0; // estimated from the sort keys in the order the draws were added and after sorting
+            ui32 stateCommands = 0; // actually written into the submitted command buffer
+        };
+
+        bool Create(bool isHeadless); // headless mode simulates on CPU and has no audio
         void Destroy();
         void Update(Vector3 mainCameraPosition, Vector3 mainCameraRotation);
         void Restart();
-        void Draw(const EngineCore::Camera &camera);
+        DrawCounts Draw(const EngineCore::Camera &camera); // the draws are sorted with RendererDrawQueue and submitted as a command buffer
     }
 }
\ No newline at end of file
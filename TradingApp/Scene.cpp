@@ -111,6 +111,7 @@ void Scene::Update()
     SceneBackground::Update();
 }
 
+// stays with the immediate draws, Line3D and Cube have no queue overloads and the scene issues a dozen draws, so there's nothing for sorting to save
 void Scene::Draw(const Camera &camera)
 {
     SceneBackground::Draw({0, 0, 0}, camera);
@@ -6,7 +6,9 @@
 #include <Logger.hpp>
 #include <RendererPipelineState.hpp>
 #include <Material.hpp>
+#include <ShadersManager.hpp>
 #include <Renderer.hpp>
+#include <RendererDrawQueue.hpp>
 #include <Texture.hpp>
 #include <TextureSampler.hpp>
 #include <MathFunctions.hpp>
@@ -38,7 +40,8 @@ bool SceneBackground::Create(bool isDepthWriteEnabled, bool isPlaneWithGrid)
 		auto cellTextureThickThin = CreateCellTexture(true);
 		auto cellTextureThick = CreateCellTexture(false);
 
-		auto shader = Application::LoadResource<Shader>("BackgroundTextured");
+		constexpr ShaderVariantKey texturedKey = BuiltinShaderKeywords::BackgroundPlane.Key("TEXTURED");
+		auto shader = Shader::Variant(Application::LoadResource<Shader>("BackgroundPlane"), texturedKey);
 		if (shader == nullptr)
 		{
 			SENDLOG(Error, "SceneBackground failed to locate shader for background plane\n");
@@ -77,7 +80,7 @@ bool SceneBackground::Create(bool isDepthWriteEnabled, bool isPlaneWithGrid)
 	}
 	else
 	{
-		auto shader = Application::LoadResource<Shader>("BackgroundColored");
+		auto shader = Application::LoadResource<Shader>("BackgroundPlane");
 		if (shader == nullptr)
 		{
 			SENDLOG(Error, "SceneBackground failed to locate shader for background plane\n");
@@ -134,6 +137,23 @@ void SceneBackground::Draw(const Vector3 &rotation, const Camera &camera)
     Application::GetRenderer().DrawWithCamera(&camera, &modelMatrix, BackgroundPlane.pipeline.get(), BackgroundPlane.material.get(), PrimitiveTopology::TriangleEnumeration, 6);
 }
 
+void SceneBackground::Draw(const Vector3 &rotation, const Camera &camera, RendererDrawQueue &queue, ui8 layer)
+{
+    if (BackgroundPlane.material == nullptr || BackgroundPlane.pipeline == nullptr)
+    {
+        return;
+    }
+
+    RendererDrawQueue::DrawDesc draw;
+    draw.camera = &camera;
+    draw.pipelineState = BackgroundPlane.pipeline.get();
+    draw.material = BackgroundPlane.material.get();
+    draw.modelMatrix = Matrix4x3::CreateRTS(rotation, nullopt, nullopt);
+    draw.count = 6;
+    draw.layer = layer;
+    queue.Add(move(draw));
+}
+
 shared_ptr<Texture> CreateCellTexture(bool isUseThinStrips)
 {
     auto funcStart = TimeMoment::Now();
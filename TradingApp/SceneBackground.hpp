@@ -3,6 +3,7 @@
 namespace EngineCore
 {
     class Camera;
+    class RendererDrawQueue;
 }
 
 namespace TradingApp
@@ -13,5 +14,6 @@ namespace TradingApp
         void Destroy();
 		void Update();
 		void Draw(const Vector3 &rotation, const EngineCore::Camera &camera);
+		void Draw(const Vector3 &rotation, const EngineCore::Camera &camera, EngineCore::RendererDrawQueue &queue, ui8 layer);
 	}
 }
\ No newline at end of file
@@ -4,9 +4,11 @@
 #include <Logger.hpp>
 #include <RendererArray.hpp>
 #include <Material.hpp>
+#include <ShadersManager.hpp>
 #include <VertexLayout.hpp>
 #include <RendererPipelineState.hpp>
 #include <Renderer.hpp>
+#include <RendererDrawQueue.hpp>
 #include <MathFunctions.hpp>
 
 using namespace EngineCore;
@@ -16,10 +18,11 @@ SpheresInstanced::SpheresInstanced(ui32 slices, ui32 layerCuts, ui32 maxInstance
 {
     assert(slices >= 3 && layerCuts >= 1);
 
-    auto shader = Application::LoadResource<Shader>("Colored3DVerticesInstanced");
+    constexpr ShaderVariantKey instancedKey = BuiltinShaderKeywords::Colored3DVertices.Key("INSTANCED");
+    auto shader = Shader::Variant(Application::LoadResource<Shader>("Colored3DVertices"), instancedKey);
     if (shader == nullptr)
     {
-        SENDLOG(Error, "Cube failed to load shader Colored3DVerticesInstanced\n");
+        SENDLOG(Error, "Cube failed to load shader Colored3DVertices+INSTANCED\n");
         return;
     }
 
@@ -138,13 +141,20 @@ void SpheresInstanced::Unlock()
     _vertexInstanceArray->UnlockDataRegion();
 }
 
-void SpheresInstanced::Draw(const Camera *camera, ui32 instancesCount)
+void SpheresInstanced::Draw(const Camera *camera, ui32 instancesCount, RendererDrawQueue &queue, ui8 layer)
 {
 	ASSUME(instancesCount <= MaxInstances());
 
-	Application::GetRenderer().BindIndexArray(_indexArray);
-    Application::GetRenderer().BindVertexArray(_vertexArray, 0);
-    Application::GetRenderer().BindVertexArray(_vertexInstanceArray, 1);
-
-    Application::GetRenderer().DrawIndexedWithCamera(camera, nullptr, _pipelineState.get(), _material.get(), PrimitiveTopology::TriangleStrip, _indexArray->NumberOfElements(), instancesCount);
+	RendererDrawQueue::DrawDesc draw;
+	draw.camera = camera;
+	draw.pipelineState = _pipelineState.get();
+	draw.material = _material.get();
+	draw.vertexArrays[0] = _vertexArray;
+	draw.vertexArrays[1] = _vertexInstanceArray;
+	draw.indexArray = _indexArray;
+	draw.topology = PrimitiveTopology::TriangleStrip;
+	draw.count = _indexArray->NumberOfElements();
+	draw.instanceCount = instancesCount;
+	draw.layer = layer;
+	queue.Add(move(draw));
 }